@@ -12,8 +12,97 @@
 #include "util.h"
 #include "run.h"
 
+#ifdef CS311_CACHE
+#include <stdlib.h>
+
+#include "cachelib.h"
+#endif
+
 enum instr_type{R, I, J};
 
+/***************************************************************/
+/*                                                             */
+/* Cache model (make cs311sim_cache): with CS311_CACHE set to  */
+/* cap:assoc:bsize[:policy] in the environment, every fetch    */
+/* goes through an instruction cache and every LW/SW through   */
+/* a data cache of that geometry. Both are reported at exit.   */
+/* Without the build flag or the variable nothing changes.     */
+/*                                                             */
+/* With CS311_TRACE set, the same accesses are also written as */
+/* a trace tagged with PCs: to a file or FIFO, or live to a    */
+/* cs311cache waiting on unix:path or shm:/name.               */
+/*                                                             */
+/***************************************************************/
+#ifdef CS311_CACHE
+static cache_t *icache, *dcache;
+static int caches_ready;
+static trace_writer trace_out;
+static int tracing;
+
+static void report_caches(void)
+{
+    printf("Instruction ");
+    cache_report(icache, false);
+    printf("Data ");
+    cache_report(dcache, false);
+    cache_destroy(icache);
+    cache_destroy(dcache);
+}
+
+static void close_trace(void)
+{
+    trace_writer_close(&trace_out);
+}
+
+static void init_caches(void)
+{
+    const char *spec = getenv("CS311_CACHE");
+    const char *trace_path = getenv("CS311_TRACE");
+
+    caches_ready = 1;
+    if (trace_path)
+    {
+        if (!trace_writer_open(&trace_out, trace_path, TRACE_FLAG_PC))
+        {
+            printf("Error: Can't open CS311_TRACE %s\n", trace_path);
+            exit(1);
+        }
+        tracing = 1;
+        atexit(close_trace);
+    }
+    if (spec == NULL)
+        return;
+
+    icache = cache_create(spec);
+    dcache = cache_create(spec);
+    if (icache == NULL || dcache == NULL)
+    {
+        printf("Error: invalid CS311_CACHE configuration %s\n", spec);
+        exit(1);
+    }
+    atexit(report_caches);
+}
+
+static void cache_touch(cache_t **cache, uint32_t address, int is_read, int is_fetch)
+{
+    if (!caches_ready)
+        init_caches();
+    if (*cache)
+        cache_access(*cache, address, is_read);
+    if (tracing)
+    {
+        trace_record record = { .addr = address, .is_read = is_read, .is_fetch = is_fetch, .pc = CURRENT_STATE.PC };
+
+        trace_write(&trace_out, &record);
+    }
+}
+#define FETCH_ACCESS(ADDR)	cache_touch(&icache, (ADDR), 1, 1)
+#define DATA_ACCESS(ADDR, IS_READ)	cache_touch(&dcache, (ADDR), (IS_READ), 0)
+#else
+#define FETCH_ACCESS(ADDR)
+#define DATA_ACCESS(ADDR, IS_READ)
+#endif
+
 /***************************************************************/
 /*                                                             */
 /* Procedure: get_inst_info                                    */
@@ -173,6 +262,7 @@ void make_i(instruction* instr, CPU_State * state)
 
         case 0x23: // LW
         {
+            DATA_ACCESS(state->REGS[rs] + imm, 1);
             state->REGS[rt] = mem_read_32(state->REGS[rs] + imm);
             break;
         }
@@ -191,6 +281,7 @@ void make_i(instruction* instr, CPU_State * state)
 
         case 0x2B: // SW
         {
+            DATA_ACCESS(state->REGS[rs] + imm, 0);
             mem_write_32(state->REGS[rs] + imm, state->REGS[rt]);
             break;
         }
@@ -238,6 +329,7 @@ void process_instruction() {
         return;
     }
 
+    FETCH_ACCESS(CURRENT_STATE.PC);
     instruction* instr = get_inst_info(CURRENT_STATE.PC);
     short op_code = OPCODE(instr);
     type = get_type(op_code, type);
@@ -13,8 +13,95 @@
 #include "util.h"
 #include "run.h"
 
+#ifdef CS311_CACHE
+#include <stdlib.h>
+
+#include "cachelib.h"
+#endif
+
 enum instr_type {R, I, J};
 
+/***************************************************************/
+/*                                                             */
+/* Cache model (make cs311sim_cache): with CS311_CACHE set to  */
+/* cap:assoc:bsize[:policy] in the environment, every fetch in */
+/* IF goes through an instruction cache and every load and     */
+/* store in MEM through a data cache of that geometry. Both    */
+/* are reported at exit. The caches only count; they do not    */
+/* stall the pipeline.                                         */
+/*                                                             */
+/* With CS311_TRACE set, the same accesses are also written as */
+/* a trace tagged with PCs: to a file or FIFO, or live to a    */
+/* cs311cache waiting on unix:path or shm:/name.               */
+/*                                                             */
+/***************************************************************/
+#ifdef CS311_CACHE
+static cache_t *icache, *dcache;
+static bool caches_ready;
+static trace_writer trace_out;
+static bool tracing;
+
+static void report_caches()
+{
+    printf("Instruction ");
+    cache_report(icache, false);
+    printf("Data ");
+    cache_report(dcache, false);
+    cache_destroy(icache);
+    cache_destroy(dcache);
+}
+
+static void close_trace()
+{
+    trace_writer_close(&trace_out);
+}
+
+static void init_caches()
+{
+    const char *spec = getenv("CS311_CACHE");
+    const char *trace_path = getenv("CS311_TRACE");
+
+    caches_ready = true;
+    if (trace_path)
+    {
+        if (!trace_writer_open(&trace_out, trace_path, TRACE_FLAG_PC))
+        {
+            printf("Error: Can't open CS311_TRACE %s\n", trace_path);
+            exit(1);
+        }
+        tracing = true;
+        atexit(close_trace);
+    }
+    if (spec == NULL) return;
+
+    icache = cache_create(spec);
+    dcache = cache_create(spec);
+    if (icache == NULL || dcache == NULL)
+    {
+        printf("Error: invalid CS311_CACHE configuration %s\n", spec);
+        exit(1);
+    }
+    atexit(report_caches);
+}
+
+static void cache_touch(cache_t **cache, uint32_t address, bool is_read, bool is_fetch, uint32_t pc)
+{
+    if (!caches_ready) init_caches();
+    if (*cache) cache_access(*cache, address, is_read);
+    if (tracing)
+    {
+        trace_record record = { .addr = address, .is_read = is_read, .is_fetch = is_fetch, .pc = pc };
+
+        trace_write(&trace_out, &record);
+    }
+}
+#define FETCH_ACCESS(ADDR)		cache_touch(&icache, (ADDR), true, true, (ADDR))
+#define DATA_ACCESS(ADDR, IS_READ)	cache_touch(&dcache, (ADDR), (IS_READ), false, CURRENT_STATE.PIPE[MEM_STAGE])
+#else
+#define FETCH_ACCESS(ADDR)
+#define DATA_ACCESS(ADDR, IS_READ)
+#endif
+
 enum instr_type get_type(short op_code, enum instr_type type)
 {
     switch (op_code) {
@@ -361,6 +448,7 @@ void IF_Stage()
 
     if (!CURRENT_STATE.PIPE[IF_STAGE]) return;
 
+    FETCH_ACCESS(CURRENT_STATE.PC);
     CURRENT_STATE.IF_ID_PIPE.INST = instr;
     CURRENT_STATE.PC += BYTES_PER_WORD;
 }
@@ -536,6 +624,7 @@ void MEM_Stage()
 
     if (past_ex_mem->mem_control.MemRead)
     {
+        DATA_ACCESS(past_ex_mem->ALU_OUT, true);
         mem_wb->MEM_OUT = mem_read_32(past_ex_mem->ALU_OUT);
     } else
     {
@@ -544,6 +633,7 @@ void MEM_Stage()
 
     if (past_ex_mem->mem_control.MemWrite)
     {
+        DATA_ACCESS(past_ex_mem->ALU_OUT, false);
         mem_write_32(past_ex_mem->ALU_OUT, past_ex_mem->DEST);
     }
 }
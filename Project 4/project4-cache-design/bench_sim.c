@@ -0,0 +1,135 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   bench_sim.c                                               */
+/*                                                             */
+/*   Replays every synthetic pattern on a fixed set of cache   */
+/*   configurations and reports simulator throughput and miss  */
+/*   rate. Traces are generated in memory with a fixed seed,   */
+/*   so runs on different builds are directly comparable.      */
+/*   Each configuration is timed with the generic replay loop  */
+/*   and with the kernel select_kernel() picks for it.         */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "cache.h"
+#include "trace.h"
+#include "gen.h"
+
+#define BENCH_RECORDS	(1 << 21)
+#define BENCH_FOOTPRINT	(4 << 20)
+#define BENCH_REPEAT	3
+
+typedef struct bench_pattern {
+    const char *name;
+    int pattern;
+    uint32_t stride;
+    double alpha;
+} bench_pattern;
+
+static const bench_pattern patterns[] = {
+    { "stream", GEN_STREAM, 0, 0 },
+    { "stride:4096", GEN_STRIDE, 4096, 0 },
+    { "random", GEN_RANDOM, 0, 0 },
+    { "zipf:0.99", GEN_ZIPF, 0, 0.99 },
+    { "chase", GEN_CHASE, 0, 0 },
+    { "mix", GEN_MIX, 0, 0.99 },
+};
+
+static const cache_config configs[] = {
+    { 8192, 1, 32, REPL_LRU, 1 },
+    { 32768, 8, 64, REPL_LRU, 1 },
+    { 262144, 16, 64, REPL_LRU, 1 },
+    { 262144, 16, 64, REPL_SRRIP, 1 },
+    { 2097152, 16, 64, REPL_TREE_PLRU, 1 },
+};
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* Best of BENCH_REPEAT fresh runs, so a cold page cache or a busy core does not count */
+static double time_replay(const cache_config *config, const trace_record *records, size_t num_records,
+                          bool specialized, cache_stats *stats) {
+    double best = 0;
+    cache_t cache;
+
+    use_specialized_kernels(specialized);
+    for (int r = 0; r < BENCH_REPEAT; r++) {
+        double start, elapsed;
+
+        cache_init(&cache, config);
+        start = now_seconds();
+        cache.replay(&cache, records, num_records);
+        elapsed = now_seconds() - start;
+
+        if (best == 0 || elapsed < best)
+            best = elapsed;
+        *stats = cache.stats;
+        cache_free(&cache);
+    }
+
+    return best;
+}
+
+int main(int argc, char *argv[]) {
+    size_t num_records = argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_RECORDS;
+    trace_record *records = (trace_record *) malloc(sizeof(trace_record) * num_records);
+    double total_accesses = 0, total_time = 0, total_generic_time = 0;
+
+    printf("Footprint: %dB, %zu accesses x %d, 20%% writes\n", BENCH_FOOTPRINT, num_records, BENCH_REPEAT);
+    printf("-------------------------------------\n");
+
+    for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+        gen_config gen_config = { patterns[p].pattern, BENCH_FOOTPRINT, patterns[p].stride, patterns[p].alpha, 20, 1 };
+        gen_t gen;
+
+        if (!gen_init(&gen, &gen_config)) {
+            printf("Error: invalid generator configuration %s\n", patterns[p].name);
+            exit(1);
+        }
+        for (size_t i = 0; i < num_records; i++)
+            gen_next(&gen, &records[i]);
+        gen_free(&gen);
+
+        for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+            const cache_config *config = &configs[c];
+            cache_stats generic_stats, stats;
+            double generic_time, best;
+            char name[32];
+
+            generic_time = time_replay(config, records, num_records, false, &generic_stats);
+            best = time_replay(config, records, num_records, true, &stats);
+
+            snprintf(name, sizeof(name), "%d:%d:%d", config->capacity, config->assoc, config->block_size);
+            if (memcmp(&generic_stats, &stats, sizeof(cache_stats)) != 0) {
+                printf("Error: %s %s kernel stats differ from the generic loop\n", patterns[p].name, name);
+                exit(1);
+            }
+            total_accesses += num_records;
+            total_time += best;
+            total_generic_time += generic_time;
+            printf("%-12s %-13s %-5s: %8.2f M accesses/s  (%.2fx)  miss rate %.4f\n", patterns[p].name, name,
+                   repl_policies[config->policy].name, num_records / best / 1e6, generic_time / best,
+                   (double) (stats.read_misses + stats.write_misses) / num_records);
+        }
+    }
+
+    printf("-------------------------------------\n");
+    printf("Overall: %.2f M accesses/s  (%.2fx)\n", total_accesses / total_time / 1e6,
+           total_generic_time / total_time);
+
+    free(records);
+    return 0;
+}
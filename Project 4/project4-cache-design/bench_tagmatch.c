@@ -0,0 +1,94 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   bench_tagmatch.c                                          */
+/*                                                             */
+/*   Replays a trace on 8/16/32-way caches with each tag       */
+/*   compare implementation and reports the throughput.        */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "cache.h"
+#include "trace.h"
+#include "sweep.h"
+
+#define BENCH_REPEAT	20
+
+static const char *impl_names[] = { "auto", "scalar", "sse2", "avx2" };
+
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = argc > 1 ? argv[1] : "sample_input/libquantum";
+    const int assocs[] = { 8, 16, 32 };
+    trace_reader reader;
+    trace_record *records = NULL;
+    size_t num_records = 0, max_records = 0, n;
+
+    if (!trace_open(&reader, path)) {
+        printf("Error: Can't open trace file %s\n", path);
+        exit(1);
+    }
+
+    do {
+        if (num_records == max_records) {
+            max_records = max_records ? max_records * 2 : SWEEP_CHUNK_RECORDS;
+            records = (trace_record *) realloc(records, sizeof(trace_record) * max_records);
+        }
+        n = fill_chunk(&reader, records + num_records, max_records - num_records);
+        num_records += n;
+    } while (n > 0);
+    trace_close(&reader);
+
+    printf("Trace: %s, %zu accesses x %d\n", path, num_records, BENCH_REPEAT);
+    printf("-------------------------------------\n");
+
+    for (size_t a = 0; a < sizeof(assocs) / sizeof(assocs[0]); a++) {
+        double scalar_time = 0;
+        cache_stats reference;
+
+        for (int impl = TAG_MATCH_SCALAR; impl <= TAG_MATCH_AVX2; impl++) {
+            cache_config config = { 65536, assocs[a], 64, REPL_LRU, 1 };
+            cache_t cache;
+            double start, elapsed;
+
+            if (!select_tag_match(impl))
+                continue;
+
+            cache_init(&cache, &config);
+            start = now_seconds();
+            for (int r = 0; r < BENCH_REPEAT; r++)
+                for (size_t i = 0; i < num_records; i++)
+                    cache_access(&cache, records[i].addr, records[i].is_read);
+            elapsed = now_seconds() - start;
+
+            if (impl == TAG_MATCH_SCALAR) {
+                scalar_time = elapsed;
+                reference = cache.stats;
+            } else if (memcmp(&reference, &cache.stats, sizeof(cache_stats)) != 0) {
+                printf("Error: %s stats differ from scalar\n", impl_names[impl]);
+                exit(1);
+            }
+
+            printf("%2d-way %-6s: %8.2f M accesses/s  (%.2fx)\n", assocs[a], impl_names[impl],
+                   num_records * (double) BENCH_REPEAT / elapsed / 1e6, scalar_time / elapsed);
+            cache_free(&cache);
+        }
+    }
+
+    free(records);
+    return 0;
+}
@@ -0,0 +1,782 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   cache.c                                                   */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "cache.h"
+#include "trace.h"
+#include "prefetch.h"
+#include "miss.h"
+#include "wbuf.h"
+#include "sample.h"
+#include "profile.h"
+#include "classify.h"
+#include "skew.h"
+
+static const char *write_policy_names[NUM_WRITE_POLICIES] = { "back", "back-noalloc", "through", "around" };
+static const char *index_names[NUM_INDEX] = { "mod", "xor", "skew", "z" };
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : cdump                                           */
+/*                                                             */
+/* Purpose   : Dump cache configuration                        */
+/*                                                             */
+/***************************************************************/
+void cdump(int capacity, int assoc, int blocksize) {
+    printf("Cache Configuration:\n");
+    printf("-------------------------------------\n");
+    printf("Capacity: %dB\n", capacity);
+    printf("Associativity: %dway\n", assoc);
+    printf("Block Size: %dB\n", blocksize);
+    printf("\n");
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : policy_dump                                     */
+/*                                                             */
+/* Purpose   : Dump replacement policy and its metadata cost   */
+/*                                                             */
+/***************************************************************/
+void policy_dump(const cache_t *cache) {
+    printf("Replacement Policy: %s\n", cache->policy->name);
+    printf("Policy Metadata: %zu bits/set\n", cache->policy->meta_size(cache->assoc) * 8);
+    printf("\n");
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : index_dump                                      */
+/*                                                             */
+/* Purpose   : Dump set indexing other than modulo             */
+/*                                                             */
+/***************************************************************/
+void index_dump(const cache_t *cache) {
+    printf("Set Indexing: %s\n", index_name(cache->index));
+    if (cache->skew)
+        skew_dump(cache->skew);
+    printf("\n");
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : sdump                                           */
+/*                                                             */
+/* Purpose   : Dump cache stat		                       */
+/*                                                             */
+/***************************************************************/
+void sdump(uint64_t total_reads, uint64_t total_writes, uint64_t write_backs,
+           uint64_t reads_hits, uint64_t write_hits, uint64_t reads_misses, uint64_t write_misses) {
+    printf("Cache Stat:\n");
+    printf("-------------------------------------\n");
+    printf("Total reads: %" PRIu64 "\n", total_reads);
+    printf("Total writes: %" PRIu64 "\n", total_writes);
+    printf("Write-backs: %" PRIu64 "\n", write_backs);
+    printf("Read hits: %" PRIu64 "\n", reads_hits);
+    printf("Write hits: %" PRIu64 "\n", write_hits);
+    printf("Read misses: %" PRIu64 "\n", reads_misses);
+    printf("Write misses: %" PRIu64 "\n", write_misses);
+    printf("\n");
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : xdump                                           */
+/*                                                             */
+/* Purpose   : Dump current cache state                        */
+/* 							       */
+/* Cache Design						       */
+/*  							       */
+/* 	    cache[set][assoc][word per block]		       */
+/*      						       */
+/*      						       */
+/*       ----------------------------------------	       */
+/*       I        I  way0  I  way1  I  way2  I                 */
+/*       ----------------------------------------              */
+/*       I        I  word0 I  word0 I  word0 I                 */
+/*       I  set0  I  word1 I  word1 I  work1 I                 */
+/*       I        I  word2 I  word2 I  word2 I                 */
+/*       I        I  word3 I  word3 I  word3 I                 */
+/*       ----------------------------------------              */
+/*       I        I  word0 I  word0 I  word0 I                 */
+/*       I  set1  I  word1 I  word1 I  work1 I                 */
+/*       I        I  word2 I  word2 I  word2 I                 */
+/*       I        I  word3 I  word3 I  word3 I                 */
+/*       ----------------------------------------              */
+/*      						       */
+/*                                                             */
+/***************************************************************/
+
+void xdump(int set, int way, const cache_t *cache) {
+    int i, j, k = 0;
+
+    printf("Cache Content:\n");
+    printf("-------------------------------------\n");
+    for (i = 0; i < way; i++) {
+        if (i == 0) {
+            printf("    ");
+        }
+        printf("      WAY[%d]", i);
+    }
+    printf("\n");
+
+    for (i = 0; i < set; i++) {
+        printf("SET[%d]:   ", i);
+        for (j = 0; j < way; j++) {
+            if (k != 0 && j == 0) {
+                printf("          ");
+            }
+            printf("0x%08x  ", block_addr(cache, i, j));
+        }
+        printf("\n");
+    }
+    printf("\n");
+}
+
+void parse_cache_args(char *cache_args, int *capacity, int *assoc, int *block_size) {
+    int cache_arg_num = 0;
+    char *token;
+    token = strtok(cache_args, ":");
+
+    while (token) {
+        switch (cache_arg_num) {
+            case 0:
+                *capacity = strtol(token, NULL, 10);
+                break;
+            case 1:
+                *assoc = strtol(token, NULL, 10);
+                break;
+            case 2:
+                *block_size = strtol(token, NULL, 10);
+                break;
+        }
+
+        token = strtok(NULL, ":");
+        cache_arg_num++;
+    }
+}
+
+/* Returns the WP_ value for a -w name, or -1 */
+int parse_write_policy(const char *name) {
+    for (int i = 0; i < NUM_WRITE_POLICIES; i++) {
+        if (strcmp(name, write_policy_names[i]) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+/* Returns the INDEX_ value for a -i name such as xor or z:3, or -1 */
+int parse_index(const char *name, int *zcache_levels) {
+    const char *colon = strchr(name, ':');
+    size_t len = colon ? (size_t) (colon - name) : strlen(name);
+
+    for (int i = 0; i < NUM_INDEX; i++) {
+        if (strlen(index_names[i]) != len || strncmp(name, index_names[i], len) != 0)
+            continue;
+        *zcache_levels = DEFAULT_ZCACHE_LEVELS;
+        if (colon) {
+            *zcache_levels = strtol(colon + 1, NULL, 10);
+            if (i != INDEX_ZCACHE || *zcache_levels < 1 || *zcache_levels > MAX_ZCACHE_LEVELS)
+                return -1;
+        }
+        return i;
+    }
+
+    return -1;
+}
+
+const char *index_name(int index) {
+    static const char *titles[NUM_INDEX] = { "modulo", "xor", "skewed", "zcache" };
+
+    return titles[index];
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : allocate_cache                                  */
+/*                                                             */
+/* Purpose   : Allocate every set in one cache-line aligned    */
+/*             block. Each set is laid out as                  */
+/*                                                             */
+/*       valid[mask_words] dirty[mask_words]  (one bit per way)*/
+/*       tags[assoc]                          (uint32_t)       */
+/*       replacement metadata                 (policy defined) */
+/*                                                             */
+/*             padded to a whole number of cache lines, so an  */
+/*             8-way LRU set fits in one line and 16 ways in   */
+/*             two.                                            */
+/*                                                             */
+/***************************************************************/
+uint8_t *allocate_cache(cache_t *cache) {
+    int assoc = cache->assoc;
+    size_t meta_size = cache->policy->meta_size(assoc);
+    size_t bytes, vector_bytes;
+    uint8_t *sets;
+
+    cache->mask_words = (assoc + 63) / 64;
+    bytes = sizeof(uint64_t) * 2 * cache->mask_words + sizeof(uint32_t) * assoc + meta_size;
+
+    /* find_way() loads tags eight at a time */
+    vector_bytes = sizeof(uint64_t) * 2 * cache->mask_words + sizeof(uint32_t) * ((assoc + 7) & ~7);
+    if (bytes < vector_bytes)
+        bytes = vector_bytes;
+    cache->set_stride = (bytes + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+
+    sets = (uint8_t *) aligned_alloc(CACHE_LINE_SIZE, cache->set_stride * cache->num_sets);
+    if (sets == NULL)
+        return NULL;
+    memset(sets, 0, cache->set_stride * cache->num_sets);
+
+    cache->sets = sets;
+    for (int i = 0; i < cache->num_sets; i++)
+        cache->policy->init(SET_META(cache, i), assoc);
+
+    return sets;
+}
+
+/* Block-aligned address held by a way, or 0 if the way is empty */
+uint32_t block_addr(const cache_t *cache, uint32_t set_index, int way) {
+    uint32_t tag = SET_TAGS(cache, set_index)[way];
+    uint32_t low;
+
+    if (!TEST_WAY(SET_VALID(cache, set_index), way))
+        return 0;
+    if (cache->index == INDEX_MOD)
+        return (tag * cache->num_sets + set_index) * cache->block_size;
+
+    low = set_index ^ (cache->skew ? skew_hash(tag, way, cache->set_bits) : tag);
+    return ((tag << cache->set_bits) | (low & (cache->num_sets - 1))) * cache->block_size;
+}
+
+static int find_way_scalar(const cache_t *cache, uint32_t set_index, uint32_t tag) {
+    const uint64_t *valid = SET_VALID(cache, set_index);
+    const uint32_t *tags = SET_TAGS(cache, set_index);
+
+    for (int i = 0; i < cache->assoc; i++) {
+        if (tags[i] == tag && TEST_WAY(valid, i))
+            return i;
+    }
+
+    return -1;
+}
+
+/*
+ * Vector tag match. Ways are compared a register at a time and the
+ * compare mask is ANDed with the valid bits, so the first hit comes out
+ * of a count-trailing-zeros. Loads may run past the last way: sets are
+ * padded by allocate_cache() to cover it, and lanes beyond assoc never
+ * have a valid bit.
+ */
+#if defined(__x86_64__) || defined(__i386__)
+static int find_way_sse2(const cache_t *cache, uint32_t set_index, uint32_t tag) {
+    const uint64_t *valid = SET_VALID(cache, set_index);
+    const uint32_t *tags = SET_TAGS(cache, set_index);
+    __m128i key = _mm_set1_epi32((int) tag);
+
+    for (int i = 0; i < cache->assoc; i += 4) {
+        __m128i t = _mm_loadu_si128((const __m128i *) (tags + i));
+        uint32_t match = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(t, key)));
+
+        match &= (uint32_t) (valid[i >> 6] >> (i & 63));
+        if (match)
+            return i + __builtin_ctz(match);
+    }
+
+    return -1;
+}
+
+__attribute__((target("avx2")))
+static int find_way_avx2(const cache_t *cache, uint32_t set_index, uint32_t tag) {
+    const uint64_t *valid = SET_VALID(cache, set_index);
+    const uint32_t *tags = SET_TAGS(cache, set_index);
+    __m256i key = _mm256_set1_epi32((int) tag);
+
+    for (int i = 0; i < cache->assoc; i += 8) {
+        __m256i t = _mm256_loadu_si256((const __m256i *) (tags + i));
+        uint32_t match = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(t, key)));
+
+        match &= (uint32_t) (valid[i >> 6] >> (i & 63));
+        if (match)
+            return i + __builtin_ctz(match);
+    }
+
+    return -1;
+}
+#endif
+
+static int (*find_way_impl)(const cache_t *, uint32_t, uint32_t);
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : select_tag_match                                */
+/*                                                             */
+/* Purpose   : Pick the tag compare used by find_way().        */
+/*             TAG_MATCH_AUTO takes the widest one the CPU     */
+/*             supports. Returns false if unsupported.         */
+/*                                                             */
+/***************************************************************/
+bool select_tag_match(int impl) {
+#if defined(__x86_64__) || defined(__i386__)
+    bool has_avx2 = __builtin_cpu_supports("avx2");
+    bool has_sse2 = __builtin_cpu_supports("sse2");
+#else
+    bool has_avx2 = false;
+    bool has_sse2 = false;
+#endif
+
+    if (impl == TAG_MATCH_AUTO)
+        impl = has_avx2 ? TAG_MATCH_AVX2 : has_sse2 ? TAG_MATCH_SSE2 : TAG_MATCH_SCALAR;
+
+    switch (impl) {
+        case TAG_MATCH_SCALAR:
+            find_way_impl = find_way_scalar;
+            return true;
+#if defined(__x86_64__) || defined(__i386__)
+        case TAG_MATCH_SSE2:
+            if (!has_sse2)
+                return false;
+            find_way_impl = find_way_sse2;
+            return true;
+        case TAG_MATCH_AVX2:
+            if (!has_avx2)
+                return false;
+            find_way_impl = find_way_avx2;
+            return true;
+#endif
+    }
+
+    return false;
+}
+
+int find_way(const cache_t *cache, uint32_t set_index, uint32_t tag) {
+    return find_way_impl(cache, set_index, tag);
+}
+
+/* First empty way, otherwise the one chosen by the replacement policy */
+int get_victim_block(cache_t *cache, uint32_t set_index) {
+    const uint64_t *valid = SET_VALID(cache, set_index);
+    int assoc = cache->assoc;
+
+    for (int w = 0; w < cache->mask_words; w++) {
+        uint64_t empty = ~valid[w];
+
+        if (w == cache->mask_words - 1 && (assoc & 63))
+            empty &= WAY_BIT(assoc) - 1;
+        if (empty)
+            return w * 64 + __builtin_ctzll(empty);
+    }
+
+    return cache->policy->victim(SET_META(cache, set_index), assoc, &cache->rng);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : cache_init                                      */
+/*                                                             */
+/* Purpose   : Allocate one cache configuration. Returns false */
+/*             if the geometry does not give at least one set  */
+/*             or a helper can't be created; nothing is left   */
+/*             allocated then.                                 */
+/*                                                             */
+/***************************************************************/
+bool cache_init(cache_t *cache, const cache_config *config) {
+    int assoc = config->assoc;
+
+    memset(cache, 0, sizeof(cache_t));
+
+    if (config->capacity <= 0 || assoc <= 0 || assoc > CACHE_MAX_ASSOC || config->block_size <= 0)
+        return false;
+    if (config->policy < 0 || config->policy >= NUM_REPL)
+        return false;
+    if (config->write_policy < 0 || config->write_policy >= NUM_WRITE_POLICIES)
+        return false;
+    if (config->index < 0 || config->index >= NUM_INDEX)
+        return false;
+
+    cache->capacity = config->capacity;
+    cache->assoc = assoc;
+    cache->block_size = config->block_size;
+    cache->num_sets = (config->capacity / assoc) / config->block_size;
+    if (cache->num_sets < 1)
+        return false;
+
+    cache->index = config->index;
+    if (cache->index != INDEX_MOD) {
+        if (cache->num_sets & (cache->num_sets - 1))
+            return false;
+        cache->set_bits = __builtin_ctz(cache->num_sets);
+    }
+
+    cache->policy = &repl_policies[config->policy];
+    if (cache->policy->needs_pow2_assoc && (assoc & (assoc - 1)))
+        return false;
+    cache->rng = config->seed ? config->seed : 1;
+    cache->write_policy = config->write_policy;
+    cache->report_writes = config->report_writes || config->write_policy != WP_BACK || config->wcb_depth > 0;
+    cache->walk_stats = config->walk_stats;
+    cache->filter = config->filter;
+
+    if (find_way_impl == NULL)
+        select_tag_match(TAG_MATCH_AUTO);
+
+    if (allocate_cache(cache) == NULL)
+        return false;
+    if (config->prefetcher != PF_NONE)
+        cache->prefetch = prefetch_create(cache, config->prefetcher, config->prefetch_degree);
+    if (config->victim_entries > 0 && (cache->victim = victim_create(cache, config->victim_entries)) == NULL) {
+        cache_free(cache);
+        return false;
+    }
+    if (config->mshrs > 0)
+        cache->mshr = mshr_create(config->mshrs, config->mshr_latency);
+    if (config->wcb_depth > 0)
+        cache->wbuf = wbuf_create(config->wcb_depth, config->block_size);
+    if (config->sample_ratio > 1 || config->sample_period > 0)
+        cache->sample = sample_create(cache, config->sample_ratio, config->sample_measure, config->sample_warmup,
+                                      config->sample_period);
+    if (config->profile_region > 0)
+        cache->profile = profile_create(cache, config->profile_top, config->profile_region);
+    if (config->classify && (cache->classify = classify_create(cache)) == NULL) {
+        cache_free(cache);
+        return false;
+    }
+    if (cache->index >= INDEX_SKEW &&
+        (cache->skew = skew_create(cache, cache->index == INDEX_ZCACHE ? config->zcache_levels : 1)) == NULL) {
+        cache_free(cache);
+        return false;
+    }
+    cache->replay = select_kernel(cache);
+
+    return true;
+}
+
+void cache_free(cache_t *cache) {
+    prefetch_free(cache->prefetch);
+    victim_free(cache->victim);
+    mshr_free(cache->mshr);
+    wbuf_free(cache->wbuf);
+    sample_free(cache->sample);
+    profile_free(cache->profile);
+    classify_free(cache->classify);
+    skew_free(cache->skew);
+    free(cache->sets);
+    memset(cache, 0, sizeof(cache_t));
+}
+
+/*
+ * Pass one transfer to the next level on to the miss stream: block fills
+ * as reads, dirty victims and stores sent through as writes.
+ */
+void filter_emit(cache_t *cache, uint32_t addr, bool is_read) {
+    trace_record record;
+
+    memset(&record, 0, sizeof(trace_record));
+    record.addr = addr;
+    record.is_read = is_read;
+    trace_write(cache->filter, &record);
+}
+
+/* A store the cache does not keep dirty goes on to the next level */
+static void write_through(cache_t *cache, uint32_t addr) {
+    cache->stats.write_throughs++;
+    if (cache->wbuf)
+        wbuf_write(cache->wbuf, addr);
+    if (cache->filter)
+        filter_emit(cache, addr, false);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : cache_access                                    */
+/*                                                             */
+/* Purpose   : Simulate one read or write on a configuration.  */
+/*             Returns true on a hit.                          */
+/*                                                             */
+/***************************************************************/
+bool cache_access(cache_t *cache, uint32_t trace_address, bool is_trace_read) {
+    uint32_t block_address = trace_address / cache->block_size;
+    uint32_t set_index = cache_set(cache, block_address);
+    uint32_t tag = cache_tag(cache, block_address);
+    uint64_t *valid = SET_VALID(cache, set_index);
+    uint64_t *dirty = SET_DIRTY(cache, set_index);
+    int way;
+    bool is_fill;
+    bool is_through = (cache->write_policy == WP_THROUGH || cache->write_policy == WP_AROUND);
+
+    if (cache->skew)
+        return skew_access(cache, trace_address, is_trace_read);
+
+    way = find_way(cache, set_index, tag);
+    is_fill = (way < 0);
+
+    if (way >= 0) {
+        if (is_trace_read)
+            cache->stats.read_hits++;
+
+        else {
+            cache->stats.write_hits++;
+            if (is_through)
+                write_through(cache, trace_address);
+            else
+                dirty[way >> 6] |= WAY_BIT(way);
+        }
+    } else {
+        if (is_trace_read)
+            cache->stats.read_misses++;
+
+        else {
+            cache->stats.write_misses++;
+            if (cache->write_policy == WP_BACK_NOALLOC || cache->write_policy == WP_AROUND) {
+                write_through(cache, trace_address);
+                if (cache->profile)
+                    profile_access(cache->profile, set_index, trace_address, false);
+                return false;
+            }
+        }
+
+        way = get_victim_block(cache, set_index);
+
+        if (cache->filter)
+            filter_emit(cache, block_address * cache->block_size, true);
+        if (TEST_WAY(dirty, way)) {
+            cache->stats.write_backs++;
+            if (cache->filter)
+                filter_emit(cache, block_addr(cache, set_index, way), false);
+        }
+        if (cache->profile && TEST_WAY(valid, way))
+            profile_evict(cache->profile, set_index, block_addr(cache, set_index, way), TEST_WAY(dirty, way));
+
+        valid[way >> 6] |= WAY_BIT(way);
+        if (is_trace_read)
+            dirty[way >> 6] &= ~WAY_BIT(way);
+        else if (is_through) {
+            dirty[way >> 6] &= ~WAY_BIT(way);
+            write_through(cache, trace_address);
+        } else
+            dirty[way >> 6] |= WAY_BIT(way);
+        SET_TAGS(cache, set_index)[way] = tag;
+    }
+
+    cache->policy->touch(SET_META(cache, set_index), cache->assoc, way, is_fill, &cache->rng);
+    if (cache->profile)
+        profile_access(cache->profile, set_index, trace_address, !is_fill);
+    return !is_fill;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Block-level operations used by multi-level simulation.      */
+/* They update content and replacement state but no counters;  */
+/* the caller decides what each transfer counts as.            */
+/*                                                             */
+/***************************************************************/
+
+/* Hit check; a hit refreshes the replacement state and a write marks the block dirty */
+bool cache_lookup(cache_t *cache, uint32_t addr, bool is_write) {
+    uint32_t block_address = addr / cache->block_size;
+    uint32_t set_index = cache_set(cache, block_address);
+    int way = find_way(cache, set_index, cache_tag(cache, block_address));
+
+    if (way < 0)
+        return false;
+
+    if (is_write)
+        SET_DIRTY(cache, set_index)[way >> 6] |= WAY_BIT(way);
+    cache->policy->touch(SET_META(cache, set_index), cache->assoc, way, false, &cache->rng);
+    return true;
+}
+
+/* Place a block that is known to be absent. Returns true if a valid block was evicted. */
+bool cache_insert(cache_t *cache, uint32_t addr, bool dirty, uint32_t *victim_addr, bool *victim_dirty) {
+    uint32_t block_address = addr / cache->block_size;
+    uint32_t set_index = cache_set(cache, block_address);
+    uint64_t *valid = SET_VALID(cache, set_index);
+    uint64_t *dirty_bits = SET_DIRTY(cache, set_index);
+    int way = get_victim_block(cache, set_index);
+    bool evicted = TEST_WAY(valid, way);
+
+    if (evicted) {
+        *victim_addr = block_addr(cache, set_index, way);
+        *victim_dirty = TEST_WAY(dirty_bits, way);
+    }
+
+    valid[way >> 6] |= WAY_BIT(way);
+    if (dirty)
+        dirty_bits[way >> 6] |= WAY_BIT(way);
+    else
+        dirty_bits[way >> 6] &= ~WAY_BIT(way);
+    SET_TAGS(cache, set_index)[way] = cache_tag(cache, block_address);
+    cache->policy->touch(SET_META(cache, set_index), cache->assoc, way, true, &cache->rng);
+
+    return evicted;
+}
+
+/* Drop a block if present. Returns true if it was there. */
+bool cache_invalidate(cache_t *cache, uint32_t addr, bool *was_dirty) {
+    uint32_t block_address = addr / cache->block_size;
+    uint32_t set_index = cache_set(cache, block_address);
+    int way = find_way(cache, set_index, cache_tag(cache, block_address));
+
+    if (way < 0)
+        return false;
+
+    *was_dirty = TEST_WAY(SET_DIRTY(cache, set_index), way);
+    SET_VALID(cache, set_index)[way >> 6] &= ~WAY_BIT(way);
+    SET_DIRTY(cache, set_index)[way >> 6] &= ~WAY_BIT(way);
+    return true;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : cache_report                                    */
+/*                                                             */
+/* Purpose   : Dump configuration, stats and optionally the    */
+/*             content of one configuration                    */
+/*                                                             */
+/***************************************************************/
+void cache_report(const cache_t *cache, bool print_cache) {
+    cdump(cache->capacity, cache->assoc, cache->block_size);
+    if (cache->policy != &repl_policies[REPL_LRU])
+        policy_dump(cache);
+    if (cache->index != INDEX_MOD)
+        index_dump(cache);
+    stats_dump(&cache->stats);
+    if (cache->classify)
+        classify_report(cache);
+    if (cache->prefetch)
+        prefetch_report(cache);
+    if (cache->victim || cache->mshr)
+        miss_report(cache);
+    if (cache->report_writes)
+        write_report(cache);
+    if (cache->walk_stats)
+        walk_report(cache);
+    if (cache->filter)
+        filter_report(cache);
+    if (cache->sample)
+        sample_report(cache);
+    if (cache->profile && cache->profile->top > 0)
+        profile_report(cache);
+
+    if (print_cache)
+        xdump(cache->num_sets, cache->assoc, cache);
+}
+
+void stats_dump(const cache_stats *stats) {
+    sdump(stats->read_hits + stats->read_misses, stats->write_hits + stats->write_misses, stats->write_backs,
+          stats->read_hits, stats->write_hits, stats->read_misses, stats->write_misses);
+}
+
+/* Bytes written to the next level: dirty blocks plus stores sent through */
+uint64_t write_traffic(const cache_t *cache) {
+    uint64_t bytes = cache->stats.write_backs * cache->block_size;
+
+    if (cache->wbuf)
+        return bytes + wbuf_bytes(cache->wbuf);
+
+    return bytes + cache->stats.write_throughs * CACHE_WORD_SIZE;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : write_report                                    */
+/*                                                             */
+/* Purpose   : Dump write policy and write traffic stat        */
+/*                                                             */
+/***************************************************************/
+void write_report(const cache_t *cache) {
+    printf("Write Traffic:\n");
+    printf("-------------------------------------\n");
+    printf("Write policy: %s\n", write_policy_names[cache->write_policy]);
+    printf("Write-backs: %" PRIu64 " (%" PRIu64 " bytes)\n", cache->stats.write_backs,
+           cache->stats.write_backs * cache->block_size);
+    printf("Stores sent through: %" PRIu64 "\n", cache->stats.write_throughs);
+    if (cache->wbuf) {
+        printf("Write buffer: %d entries\n", cache->wbuf->depth);
+        printf("Combined stores: %" PRIu64 "\n", cache->wbuf->combined);
+        printf("Buffer drains: %" PRIu64 "\n", cache->wbuf->drains);
+    }
+    printf("Bytes to next level: %" PRIu64 "\n", write_traffic(cache));
+    printf("\n");
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : walk_report                                     */
+/*                                                             */
+/* Purpose   : Dump how the page walker's PTE reads fared      */
+/*                                                             */
+/***************************************************************/
+void walk_report(const cache_t *cache) {
+    uint64_t pte_reads = cache->stats.walk_hits + cache->stats.walk_misses;
+
+    printf("Page Walk Stat:\n");
+    printf("-------------------------------------\n");
+    printf("PTE reads: %" PRIu64 "\n", pte_reads);
+    printf("PTE hits: %" PRIu64 "\n", cache->stats.walk_hits);
+    printf("PTE misses: %" PRIu64 "\n", cache->stats.walk_misses);
+    printf("PTE miss rate: %.2f%%\n", pte_reads ? 100.0 * cache->stats.walk_misses / pte_reads : 0.0);
+    printf("\n");
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : filter_report                                   */
+/*                                                             */
+/* Purpose   : Dump the size of the miss stream written out    */
+/*                                                             */
+/***************************************************************/
+void filter_report(const cache_t *cache) {
+    uint64_t accesses = cache->stats.read_hits + cache->stats.read_misses + cache->stats.write_hits +
+                        cache->stats.write_misses;
+    uint64_t records = cache->filter->num_records;
+
+    printf("Miss Stream:\n");
+    printf("-------------------------------------\n");
+    printf("Records written: %" PRIu64 "\n", records);
+    printf("Fills: %" PRIu64 "\n", records - cache->stats.write_backs - cache->stats.write_throughs);
+    printf("Writes: %" PRIu64 "\n", cache->stats.write_backs + cache->stats.write_throughs);
+    printf("Records per access: %.4f\n", accesses ? (double) records / accesses : 0.0);
+    printf("\n");
+}
+
+void cache_report_csv_header(void) {
+    printf("capacity,associativity,block_size,policy,total_reads,total_writes,write_backs,"
+           "read_hits,write_hits,read_misses,write_misses\n");
+}
+
+/* Hashed configurations are told apart by a policy column such as lru/xor */
+void cache_report_csv(const cache_t *cache) {
+    char policy[32];
+
+    if (cache->index == INDEX_MOD)
+        snprintf(policy, sizeof(policy), "%s", cache->policy->name);
+    else if (cache->index == INDEX_ZCACHE)
+        snprintf(policy, sizeof(policy), "%s/z:%d", cache->policy->name, cache->skew->levels);
+    else
+        snprintf(policy, sizeof(policy), "%s/%s", cache->policy->name, index_names[cache->index]);
+    stats_csv(cache->capacity, cache->assoc, cache->block_size, policy, &cache->stats);
+}
+
+void stats_csv(int capacity, int assoc, int block_size, const char *policy, const cache_stats *stats) {
+    printf("%d,%d,%d,%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+           capacity, assoc, block_size, policy,
+           stats->read_hits + stats->read_misses, stats->write_hits + stats->write_misses, stats->write_backs,
+           stats->read_hits, stats->write_hits, stats->read_misses, stats->write_misses);
+}
@@ -0,0 +1,184 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   cache.h                                                   */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _CACHE_H_
+#define _CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "replacement.h"
+#include "kernel.h"
+
+struct trace_writer;
+
+#define CACHE_LINE_SIZE		64
+#define CACHE_MAX_ASSOC		65536
+
+/* Tag compare implementations for select_tag_match() */
+#define TAG_MATCH_AUTO		0
+#define TAG_MATCH_SCALAR	1
+#define TAG_MATCH_SSE2		2
+#define TAG_MATCH_AVX2		3
+
+/* Write policies for cache_config.write_policy */
+#define WP_BACK			0	/* write-back, write-allocate */
+#define WP_BACK_NOALLOC		1	/* write-back, no-write-allocate */
+#define WP_THROUGH		2	/* write-through, write-allocate */
+#define WP_AROUND		3	/* write-through, no-write-allocate */
+#define NUM_WRITE_POLICIES	4
+
+/* Set indexing for cache_config.index; all but INDEX_MOD need a power-of-two set count */
+#define INDEX_MOD		0	/* block_address % num_sets */
+#define INDEX_XOR		1	/* low bits XOR the tag's low bits */
+#define INDEX_SKEW		2	/* skewed-associative, one hash per way */
+#define INDEX_ZCACHE		3	/* skewed with a relocating candidate walk */
+#define NUM_INDEX		4
+
+#define DEFAULT_ZCACHE_LEVELS	2
+#define MAX_ZCACHE_LEVELS	3
+
+typedef struct cache_stats {
+    uint64_t read_hits;
+    uint64_t read_misses;
+    uint64_t write_hits;
+    uint64_t write_misses;
+    uint64_t write_backs;
+    uint64_t write_throughs;	/* stores sent to the next level instead of a dirty block */
+    uint64_t walk_hits;		/* PTE reads of page walks, also counted as reads */
+    uint64_t walk_misses;
+} cache_stats;
+
+typedef struct cache_config {
+    int capacity;
+    int assoc;
+    int block_size;
+    int policy;		/* index into repl_policies */
+    uint64_t seed;
+    int prefetcher;	/* PF_NONE or a prefetcher from prefetch.h */
+    int prefetch_degree;
+    int victim_entries;	/* 0 for no victim cache */
+    int mshrs;		/* 0 for no MSHR model */
+    int mshr_latency;
+    int write_policy;	/* WP_BACK unless set */
+    int wcb_depth;	/* 0 for no write-combining buffer */
+    bool report_writes;	/* print write traffic even for the default policy */
+    int sample_ratio;	/* simulate 1 in sample_ratio sets, 0 or 1 for all */
+    uint64_t sample_measure;
+    uint64_t sample_warmup;
+    uint64_t sample_period;	/* 0 for no time sampling */
+    int profile_top;
+    int profile_region;	/* 0 for no profile */
+    bool classify;	/* split misses into compulsory, capacity and conflict */
+    bool walk_stats;	/* count page walk PTE reads apart (-V) */
+    int index;		/* INDEX_MOD unless set */
+    int zcache_levels;	/* candidate walk depth of INDEX_ZCACHE */
+    struct trace_writer *filter;	/* receives the miss stream (-F), NULL for none */
+} cache_config;
+
+/* One simulated configuration: geometry, content and its own counters */
+typedef struct cache_s {
+    int capacity;
+    int assoc;
+    int block_size;
+    int num_sets;
+    int index;
+    int set_bits;		/* log2(num_sets) unless INDEX_MOD */
+
+    uint8_t *sets;		/* num_sets * set_stride bytes, see allocate_cache() */
+    size_t set_stride;
+    int mask_words;
+
+    const repl_policy *policy;
+    uint64_t rng;
+    struct prefetch_s *prefetch;	/* NULL without a prefetcher */
+    struct victim_cache *victim;	/* NULL without a victim cache */
+    struct mshr_file *mshr;		/* NULL without MSHRs */
+    int write_policy;
+    bool report_writes;
+    struct write_buffer *wbuf;		/* NULL without a write-combining buffer */
+    struct sample_s *sample;		/* NULL unless sampled */
+    struct profile_s *profile;		/* NULL unless profiled */
+    struct classify_s *classify;	/* NULL without miss classification */
+    struct skew_s *skew;		/* NULL unless skewed or a zcache */
+    bool walk_stats;
+    struct trace_writer *filter;	/* NULL unless the miss stream is written out */
+    replay_kernel replay;		/* plain replay of a chunk, see select_kernel() */
+
+    cache_stats stats;
+} cache_t;
+
+/* Per-set arrays inside cache_t.sets */
+#define SET_START(CACHE, SET)	((CACHE)->sets + (size_t) (SET) * (CACHE)->set_stride)
+#define SET_VALID(CACHE, SET)	((uint64_t *) SET_START(CACHE, SET))
+#define SET_DIRTY(CACHE, SET)	(SET_VALID(CACHE, SET) + (CACHE)->mask_words)
+#define SET_TAGS(CACHE, SET)	((uint32_t *) (SET_DIRTY(CACHE, SET) + (CACHE)->mask_words))
+#define SET_META(CACHE, SET)	((uint8_t *) (SET_TAGS(CACHE, SET) + (CACHE)->assoc))
+
+#define WAY_BIT(WAY)		((uint64_t) 1 << ((WAY) & 63))
+#define TEST_WAY(MASK, WAY)	(((MASK)[(WAY) >> 6] & WAY_BIT(WAY)) != 0)
+
+/*
+ * Address decoding. With hashed indexing the tag is every bit above the
+ * set index, so the block address can be rebuilt from tag and set. A
+ * skewed cache keeps way W of a block in set (block ^ skew_hash(tag, W)),
+ * which spreads blocks that share a set in one way over the others.
+ */
+static inline uint32_t cache_tag(const cache_t *cache, uint32_t block_address) {
+    if (cache->index == INDEX_MOD)
+        return block_address / cache->num_sets;
+    return block_address >> cache->set_bits;
+}
+
+static inline uint32_t cache_set(const cache_t *cache, uint32_t block_address) {
+    if (cache->index == INDEX_MOD)
+        return block_address % cache->num_sets;
+    return (block_address ^ (block_address >> cache->set_bits)) & (cache->num_sets - 1);
+}
+
+static inline uint32_t skew_hash(uint32_t tag, int way, int set_bits) {
+    uint32_t h = (tag ^ (uint32_t) way * 0x85EBCA6Bu) * 0x9E3779B1u;
+
+    return set_bits ? h >> (32 - set_bits) : 0;
+}
+
+/* Functions */
+void		cdump(int capacity, int assoc, int blocksize);
+void		policy_dump(const cache_t *cache);
+void		index_dump(const cache_t *cache);
+void		sdump(uint64_t total_reads, uint64_t total_writes, uint64_t write_backs,
+		      uint64_t reads_hits, uint64_t write_hits, uint64_t reads_misses, uint64_t write_misses);
+void		xdump(int set, int way, const cache_t *cache);
+void		parse_cache_args(char *cache_args, int *capacity, int *assoc, int *block_size);
+int		parse_write_policy(const char *name);
+int		parse_index(const char *name, int *zcache_levels);
+const char*	index_name(int index);
+uint8_t*	allocate_cache(cache_t *cache);
+uint32_t	block_addr(const cache_t *cache, uint32_t set_index, int way);
+bool		select_tag_match(int impl);
+int		find_way(const cache_t *cache, uint32_t set_index, uint32_t tag);
+int		get_victim_block(cache_t *cache, uint32_t set_index);
+bool		cache_init(cache_t *cache, const cache_config *config);
+void		cache_free(cache_t *cache);
+bool		cache_access(cache_t *cache, uint32_t trace_address, bool is_trace_read);
+bool		cache_lookup(cache_t *cache, uint32_t addr, bool is_write);
+bool		cache_insert(cache_t *cache, uint32_t addr, bool dirty, uint32_t *victim_addr, bool *victim_dirty);
+bool		cache_invalidate(cache_t *cache, uint32_t addr, bool *was_dirty);
+void		cache_report(const cache_t *cache, bool print_cache);
+void		cache_report_csv_header(void);
+void		cache_report_csv(const cache_t *cache);
+void		stats_dump(const cache_stats *stats);
+void		write_report(const cache_t *cache);
+void		walk_report(const cache_t *cache);
+void		filter_emit(cache_t *cache, uint32_t addr, bool is_read);
+void		filter_report(const cache_t *cache);
+uint64_t	write_traffic(const cache_t *cache);
+void		stats_csv(int capacity, int assoc, int block_size, const char *policy, const cache_stats *stats);
+
+#endif
@@ -0,0 +1,114 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   cachelib.c                                                */
+/*                                                             */
+/*   Single accesses go straight to cache_access(), which      */
+/*   cachelib.h re-exports through cache.h. The functions here */
+/*   only add what a caller without a trace needs: building a  */
+/*   configuration from a string, batches, and flushing.       */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "cachelib.h"
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : cache_create                                    */
+/*                                                             */
+/* Purpose   : Allocate a configuration from                   */
+/*             cap:assoc:bsize[:policy], e.g. 4096:4:32:plru.  */
+/*             Returns NULL if the spec is not a valid cache.  */
+/*                                                             */
+/***************************************************************/
+cache_t *cache_create(const char *spec) {
+    char *copy = strdup(spec);
+    char *policy = NULL;
+    char *colon = copy;
+    cache_config config;
+    cache_t *cache;
+
+    /* parse_cache_args() stops at three fields; the policy is the fourth */
+    for (int i = 0; i < 3 && colon; i++)
+        colon = strchr(colon + (i > 0), ':');
+    if (colon) {
+        *colon = '\0';
+        policy = colon + 1;
+    }
+
+    memset(&config, 0, sizeof(cache_config));
+    parse_cache_args(copy, &config.capacity, &config.assoc, &config.block_size);
+    config.policy = policy ? find_repl_policy(policy) : REPL_LRU;
+    config.seed = 1;
+    free(copy);
+
+    cache = (cache_t *) malloc(sizeof(cache_t));
+    if (!cache_init(cache, &config)) {
+        free(cache);
+        return NULL;
+    }
+
+    return cache;
+}
+
+void cache_destroy(cache_t *cache) {
+    if (cache == NULL)
+        return;
+
+    cache_free(cache);
+    free(cache);
+}
+
+/* Replay records in order; hits[i] is set per record if hits is not NULL. Returns the number of hits. */
+size_t cache_access_batch(cache_t *cache, const trace_record *records, size_t num_records, bool *hits) {
+    uint64_t hits_before = cache->stats.read_hits + cache->stats.write_hits;
+    size_t num_hits = 0;
+
+    /* Without per-record results the configuration's kernel can take the whole batch */
+    if (hits == NULL) {
+        cache->replay(cache, records, num_records);
+        return cache->stats.read_hits + cache->stats.write_hits - hits_before;
+    }
+
+    for (size_t i = 0; i < num_records; i++) {
+        hits[i] = cache_access(cache, records[i].addr, records[i].is_read);
+        num_hits += hits[i];
+    }
+
+    return num_hits;
+}
+
+/* Write back every dirty block and empty the cache. Returns the number of write-backs. */
+uint64_t cache_flush(cache_t *cache) {
+    uint64_t flushed = 0;
+
+    for (int set = 0; set < cache->num_sets; set++) {
+        uint64_t *valid = SET_VALID(cache, set);
+        uint64_t *dirty = SET_DIRTY(cache, set);
+
+        for (int w = 0; w < cache->mask_words; w++) {
+            flushed += __builtin_popcountll(valid[w] & dirty[w]);
+            valid[w] = 0;
+            dirty[w] = 0;
+        }
+        cache->policy->init(SET_META(cache, set), cache->assoc);
+    }
+
+    cache->stats.write_backs += flushed;
+    return flushed;
+}
+
+void cache_reset_stats(cache_t *cache) {
+    memset(&cache->stats, 0, sizeof(cache_stats));
+}
+
+const cache_stats *cache_get_stats(const cache_t *cache) {
+    return &cache->stats;
+}
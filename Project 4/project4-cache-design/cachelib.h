@@ -0,0 +1,32 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   cachelib.h                                                */
+/*                                                             */
+/*   In-process interface to the cache model, for simulators   */
+/*   that drive it on every access instead of writing a trace. */
+/*   Built as libcs311cache.a; see "make lib".                 */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _CACHELIB_H_
+#define _CACHELIB_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cache.h"
+#include "trace.h"
+
+/* Functions */
+cache_t*		cache_create(const char *spec);
+void			cache_destroy(cache_t *cache);
+size_t			cache_access_batch(cache_t *cache, const trace_record *records, size_t num_records,
+					   bool *hits);
+uint64_t		cache_flush(cache_t *cache);
+void			cache_reset_stats(cache_t *cache);
+const cache_stats*	cache_get_stats(const cache_t *cache);
+
+#endif
@@ -0,0 +1,211 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   checkpoint.c                                              */
+/*                                                             */
+/*   A snapshot is written to a temporary file and renamed     */
+/*   over the old one, so a run killed mid-write still leaves  */
+/*   the previous checkpoint intact. Only the main cache is    */
+/*   saved; configurations with prefetchers, victim caches,    */
+/*   MSHRs, write buffers, sampling, profiles or miss          */
+/*   classification carry state that is not, and are refused. */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <zlib.h>
+
+#include "cache.h"
+#include "checkpoint.h"
+
+#define CHECKPOINT_HEADER_SIZE	24
+#define CHECKPOINT_CACHE_SIZE	(5 * 4 + 2 * 8 + 6 * 8)
+
+static void store_u32(uint8_t *p, uint32_t value) {
+    for (int i = 0; i < 4; i++)
+        p[i] = (uint8_t) (value >> (8 * i));
+}
+
+static void store_u64(uint8_t *p, uint64_t value) {
+    store_u32(p, (uint32_t) value);
+    store_u32(p + 4, (uint32_t) (value >> 32));
+}
+
+static uint32_t load_u32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint64_t load_u64(const uint8_t *p) {
+    return load_u32(p) | ((uint64_t) load_u32(p + 4) << 32);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_checkpoint_args                           */
+/*                                                             */
+/* Purpose   : Parse path[:every], e.g. run.ckpt:10000000 to   */
+/*             save every ten million records and at the end   */
+/*                                                             */
+/***************************************************************/
+bool parse_checkpoint_args(char *checkpoint_args, char **path, uint64_t *every) {
+    char *colon = strrchr(checkpoint_args, ':');
+
+    *every = 0;
+    if (colon) {
+        *colon = '\0';
+        *every = strtoull(colon + 1, NULL, 10);
+        if (*every == 0)
+            return false;
+    }
+    *path = checkpoint_args;
+
+    return **path != '\0';
+}
+
+bool checkpoint_supported(const cache_t *cache) {
+    return cache->prefetch == NULL && cache->victim == NULL && cache->mshr == NULL && cache->wbuf == NULL &&
+           cache->sample == NULL && cache->profile == NULL && cache->classify == NULL && cache->index == INDEX_MOD;
+}
+
+static void pack_cache(uint8_t *p, const cache_t *cache) {
+    const uint64_t stats[6] = {
+        cache->stats.read_hits, cache->stats.read_misses, cache->stats.write_hits,
+        cache->stats.write_misses, cache->stats.write_backs, cache->stats.write_throughs
+    };
+
+    store_u32(p, cache->capacity);
+    store_u32(p + 4, cache->assoc);
+    store_u32(p + 8, cache->block_size);
+    store_u32(p + 12, (uint32_t) (cache->policy - repl_policies));
+    store_u32(p + 16, cache->write_policy);
+    store_u64(p + 20, cache->set_stride);
+    store_u64(p + 28, cache->rng);
+    for (int i = 0; i < 6; i++)
+        store_u64(p + 36 + 8 * i, stats[i]);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : checkpoint_save                                 */
+/*                                                             */
+/* Purpose   : Write every configuration and the number of     */
+/*             records replayed so far to path                 */
+/*                                                             */
+/***************************************************************/
+bool checkpoint_save(const char *path, const cache_t *caches, int num_caches, uint64_t offset) {
+    uint8_t header[CHECKPOINT_HEADER_SIZE];
+    uint8_t record[CHECKPOINT_CACHE_SIZE];
+    size_t tmp_length = strlen(path) + 5;
+    char *tmp_path = (char *) malloc(tmp_length);
+    bool ok = true;
+    gzFile gz;
+
+    snprintf(tmp_path, tmp_length, "%s.tmp", path);
+    gz = gzopen(tmp_path, "wb6");
+    if (gz == NULL) {
+        free(tmp_path);
+        return false;
+    }
+
+    memcpy(header, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE);
+    store_u32(header + 8, CHECKPOINT_VERSION);
+    store_u32(header + 12, num_caches);
+    store_u64(header + 16, offset);
+    ok = gzwrite(gz, header, sizeof(header)) == (int) sizeof(header);
+
+    for (int i = 0; i < num_caches && ok; i++) {
+        const cache_t *cache = &caches[i];
+        size_t bytes = cache->set_stride * cache->num_sets;
+
+        pack_cache(record, cache);
+        ok = gzwrite(gz, record, sizeof(record)) == (int) sizeof(record);
+        for (size_t done = 0; ok && done < bytes; ) {
+            unsigned chunk = (bytes - done > (1u << 30)) ? (1u << 30) : (unsigned) (bytes - done);
+
+            ok = gzwrite(gz, cache->sets + done, chunk) == (int) chunk;
+            done += chunk;
+        }
+    }
+
+    if (gzclose(gz) != Z_OK)
+        ok = false;
+    if (ok)
+        ok = rename(tmp_path, path) == 0;
+    else
+        remove(tmp_path);
+
+    free(tmp_path);
+    return ok;
+}
+
+static bool read_exact(gzFile gz, void *buf, size_t bytes) {
+    uint8_t *p = (uint8_t *) buf;
+
+    while (bytes > 0) {
+        unsigned chunk = (bytes > (1u << 30)) ? (1u << 30) : (unsigned) bytes;
+
+        if (gzread(gz, p, chunk) != (int) chunk)
+            return false;
+        p += chunk;
+        bytes -= chunk;
+    }
+
+    return true;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : checkpoint_load                                 */
+/*                                                             */
+/* Purpose   : Restore configurations initialized with the     */
+/*             same geometries, policies and order as when the */
+/*             checkpoint was saved. Without keep_stats only   */
+/*             the content is taken and counting starts over.  */
+/*                                                             */
+/***************************************************************/
+bool checkpoint_load(const char *path, cache_t *caches, int num_caches, uint64_t *offset, bool keep_stats) {
+    uint8_t header[CHECKPOINT_HEADER_SIZE];
+    uint8_t record[CHECKPOINT_CACHE_SIZE];
+    gzFile gz = gzopen(path, "rb");
+    bool ok;
+
+    if (gz == NULL)
+        return false;
+
+    ok = read_exact(gz, header, sizeof(header)) &&
+         memcmp(header, CHECKPOINT_MAGIC, CHECKPOINT_MAGIC_SIZE) == 0 &&
+         load_u32(header + 8) == CHECKPOINT_VERSION && load_u32(header + 12) == (uint32_t) num_caches;
+    if (ok)
+        *offset = load_u64(header + 16);
+
+    for (int i = 0; i < num_caches && ok; i++) {
+        cache_t *cache = &caches[i];
+        uint8_t expected[CHECKPOINT_CACHE_SIZE];
+
+        /* Everything up to the rng must match the configuration being resumed */
+        pack_cache(expected, cache);
+        ok = read_exact(gz, record, sizeof(record)) && memcmp(record, expected, 28) == 0 &&
+             read_exact(gz, cache->sets, cache->set_stride * cache->num_sets);
+        if (!ok)
+            break;
+
+        cache->rng = load_u64(record + 28);
+        if (keep_stats) {
+            cache->stats.read_hits = load_u64(record + 36);
+            cache->stats.read_misses = load_u64(record + 44);
+            cache->stats.write_hits = load_u64(record + 52);
+            cache->stats.write_misses = load_u64(record + 60);
+            cache->stats.write_backs = load_u64(record + 68);
+            cache->stats.write_throughs = load_u64(record + 76);
+        }
+    }
+
+    gzclose(gz);
+    return ok;
+}
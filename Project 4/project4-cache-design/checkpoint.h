@@ -0,0 +1,45 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   checkpoint.h                                              */
+/*                                                             */
+/*   Snapshots of every configuration's content, replacement   */
+/*   state and counters, with the trace position they were     */
+/*   taken at, so a run can be resumed or warm-started.        */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Checkpoint layout (gzip compressed, integers little-endian)
+ *
+ *   header : magic[8] "CS311CKP", u32 version, u32 num_caches,
+ *            u64 trace offset (records already replayed)
+ *   cache  : i32 capacity, i32 assoc, i32 block_size, i32 policy,
+ *            i32 write_policy, u64 set_stride, u64 rng,
+ *            u64 stats[6] (cache_stats field order),
+ *            num_sets * set_stride bytes of set data
+ *
+ * Set data is the flat cache_t.sets block as is, so it is in host byte
+ * order and only loads on a machine of the same endianness.
+ */
+#define CHECKPOINT_MAGIC	"CS311CKP"
+#define CHECKPOINT_MAGIC_SIZE	8
+#define CHECKPOINT_VERSION	1
+
+struct cache_s;
+
+/* Functions */
+bool	parse_checkpoint_args(char *checkpoint_args, char **path, uint64_t *every);
+bool	checkpoint_supported(const struct cache_s *cache);
+bool	checkpoint_save(const char *path, const struct cache_s *caches, int num_caches, uint64_t offset);
+bool	checkpoint_load(const char *path, struct cache_s *caches, int num_caches, uint64_t *offset,
+			bool keep_stats);
+
+#endif
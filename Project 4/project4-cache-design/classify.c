@@ -0,0 +1,74 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   classify.c                                                */
+/*                                                             */
+/*   The shadow sees every access, hit or miss, so its LRU     */
+/*   order tracks the trace and not the simulated cache.       */
+/*   Policies other than LRU can hit where the shadow misses;  */
+/*   such hits are not counted anywhere.                       */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "cache.h"
+#include "classify.h"
+
+classify_t *classify_create(const cache_t *cache) {
+    classify_t *classify = (classify_t *) calloc(1, sizeof(classify_t));
+
+    if (!sdist_init(&classify->shadow, cache->capacity, cache->capacity, SDIST_FULLY_ASSOC, cache->block_size)) {
+        free(classify);
+        return NULL;
+    }
+    classify->num_blocks = cache->capacity / cache->block_size;
+
+    return classify;
+}
+
+void classify_free(classify_t *classify) {
+    if (classify == NULL)
+        return;
+
+    sdist_free(&classify->shadow);
+    free(classify);
+}
+
+void classify_access(classify_t *classify, uint32_t addr, bool is_read, bool is_hit) {
+    uint32_t distance = sdist_distance(&classify->shadow, addr, is_read);
+
+    if (is_hit)
+        return;
+
+    if (distance == SDIST_COLD)
+        classify->compulsory++;
+    else if (distance >= classify->num_blocks)
+        classify->capacity++;
+    else
+        classify->conflict++;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : classify_report                                 */
+/*                                                             */
+/* Purpose   : Dump the miss counts split into the three Cs    */
+/*                                                             */
+/***************************************************************/
+void classify_report(const cache_t *cache) {
+    const classify_t *classify = cache->classify;
+
+    printf("Miss Classification:\n");
+    printf("-------------------------------------\n");
+    printf("Compulsory misses: %" PRIu64 "\n", classify->compulsory);
+    printf("Capacity misses: %" PRIu64 "\n", classify->capacity);
+    printf("Conflict misses: %" PRIu64 "\n", classify->conflict);
+    printf("\n");
+}
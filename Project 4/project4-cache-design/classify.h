@@ -0,0 +1,45 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   classify.h                                                */
+/*                                                             */
+/*   3C miss classification: every miss is compulsory,         */
+/*   capacity or conflict, judged against a fully-associative  */
+/*   LRU shadow cache of the same capacity.                    */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _CLASSIFY_H_
+#define _CLASSIFY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sdist.h"
+
+struct cache_s;
+
+/*
+ * The shadow is the stack-distance engine at a single capacity: its
+ * block table is the set of blocks seen so far and its Fenwick tree
+ * gives each access's LRU depth. A miss on a block never seen is
+ * compulsory, one the shadow would also miss is capacity, and one the
+ * shadow would hit is conflict.
+ */
+typedef struct classify_s {
+    sdist_t shadow;
+    uint32_t num_blocks;	/* shadow capacity in blocks */
+
+    uint64_t compulsory;
+    uint64_t capacity;
+    uint64_t conflict;
+} classify_t;
+
+/* Functions */
+classify_t*	classify_create(const struct cache_s *cache);
+void		classify_free(classify_t *classify);
+void		classify_access(classify_t *classify, uint32_t addr, bool is_read, bool is_hit);
+void		classify_report(const struct cache_s *cache);
+
+#endif
@@ -0,0 +1,405 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   coherence.c                                               */
+/*                                                             */
+/*   Each core owns a private cache_t plus a state byte per    */
+/*   way, and its own counters, so nothing but the block table */
+/*   and the interconnect counters is shared between cores.    */
+/*                                                             */
+/*   The block table records which cores hold each block.     */
+/*   Snooping and directory runs apply the same transitions    */
+/*   and differ only in the traffic they are charged: a bus    */
+/*   request is snooped by every other core, while a directory */
+/*   sends one message to the home node plus one per forward   */
+/*   or invalidation it has to issue.                          */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "coherence.h"
+
+#define CORE_BIT(CORE)	((uint64_t) 1 << (CORE))
+
+static const char *protocol_names[] = { "msi", "mesi", "moesi" };
+static const char *interconnect_names[] = { "snoop", "dir" };
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_coherence_args                            */
+/*                                                             */
+/* Purpose   : Parse cores:protocol[:snoop|dir], e.g. 4:mesi   */
+/*                                                             */
+/***************************************************************/
+bool parse_coherence_args(char *coherence_args, int *num_cores, int *protocol, int *interconnect) {
+    int coherence_arg_num = 0;
+    char *token;
+
+    *protocol = COH_MESI;
+    *interconnect = COH_SNOOP;
+
+    token = strtok(coherence_args, ":");
+    while (token) {
+        switch (coherence_arg_num) {
+            case 0:
+                *num_cores = strtol(token, NULL, 10);
+                break;
+            case 1:
+                *protocol = -1;
+                for (int i = COH_MSI; i <= COH_MOESI; i++) {
+                    if (strcmp(token, protocol_names[i]) == 0)
+                        *protocol = i;
+                }
+                break;
+            case 2:
+                *interconnect = -1;
+                for (int i = COH_SNOOP; i <= COH_DIRECTORY; i++) {
+                    if (strcmp(token, interconnect_names[i]) == 0)
+                        *interconnect = i;
+                }
+                break;
+        }
+
+        token = strtok(NULL, ":");
+        coherence_arg_num++;
+    }
+
+    return coherence_arg_num >= 1 && *num_cores >= 1 && *num_cores <= COH_MAX_CORES && *protocol >= 0 &&
+           *interconnect >= 0;
+}
+
+bool coherence_init(coherence_t *coherence, int num_cores, int protocol, int interconnect,
+                    const cache_config *config) {
+    memset(coherence, 0, sizeof(coherence_t));
+
+    coherence->num_cores = num_cores;
+    coherence->protocol = protocol;
+    coherence->interconnect = interconnect;
+    coherence->cores = (core_t *) calloc(num_cores, sizeof(core_t));
+
+    for (int i = 0; i < num_cores; i++) {
+        core_t *core = &coherence->cores[i];
+
+        if (!cache_init(&core->cache, config))
+            return false;
+        core->states = (uint8_t *) calloc((size_t) core->cache.num_sets * core->cache.assoc, 1);
+    }
+
+    coherence->block_table_size = 1 << 16;
+    coherence->blocks = (coh_block *) calloc(coherence->block_table_size, sizeof(coh_block));
+    return true;
+}
+
+static uint32_t hash_block(uint32_t block, uint32_t table_size) {
+    return (block * 0x9e3779b1u) & (table_size - 1);
+}
+
+static void grow_block_table(coherence_t *coherence) {
+    coh_block *old = coherence->blocks;
+    uint32_t old_size = coherence->block_table_size;
+
+    coherence->block_table_size *= 2;
+    coherence->blocks = (coh_block *) calloc(coherence->block_table_size, sizeof(coh_block));
+
+    for (uint32_t i = 0; i < old_size; i++) {
+        if (!old[i].used)
+            continue;
+
+        uint32_t h = hash_block(old[i].block, coherence->block_table_size);
+        while (coherence->blocks[h].used)
+            h = (h + 1) & (coherence->block_table_size - 1);
+        coherence->blocks[h] = old[i];
+    }
+
+    free(old);
+}
+
+/* The block must already be in the table (it is cached somewhere) */
+static coh_block *find_block(coherence_t *coherence, uint32_t block) {
+    uint32_t h = hash_block(block, coherence->block_table_size);
+
+    while (coherence->blocks[h].block != block || !coherence->blocks[h].used)
+        h = (h + 1) & (coherence->block_table_size - 1);
+
+    return &coherence->blocks[h];
+}
+
+static coh_block *lookup_block(coherence_t *coherence, uint32_t block) {
+    uint32_t h;
+
+    if (coherence->num_blocks * 2 >= coherence->block_table_size)
+        grow_block_table(coherence);
+
+    h = hash_block(block, coherence->block_table_size);
+    while (coherence->blocks[h].used) {
+        if (coherence->blocks[h].block == block)
+            return &coherence->blocks[h];
+        h = (h + 1) & (coherence->block_table_size - 1);
+    }
+
+    coherence->blocks[h].used = true;
+    coherence->blocks[h].block = block;
+    coherence->num_blocks++;
+    return &coherence->blocks[h];
+}
+
+/* Move another core's copy of block to new_state (STATE_I drops it). Returns the old state. */
+static int set_remote_state(core_t *core, uint32_t block, int new_state) {
+    cache_t *cache = &core->cache;
+    uint32_t set_index = block % cache->num_sets;
+    int way = find_way(cache, set_index, block / cache->num_sets);
+    uint8_t *state;
+    int old_state;
+
+    if (way < 0)
+        return STATE_I;
+
+    state = &core->states[(size_t) set_index * cache->assoc + way];
+    old_state = *state;
+    *state = new_state;
+
+    if (new_state == STATE_I)
+        SET_VALID(cache, set_index)[way >> 6] &= ~WAY_BIT(way);
+    if (new_state != STATE_M && new_state != STATE_O)
+        SET_DIRTY(cache, set_index)[way >> 6] &= ~WAY_BIT(way);
+
+    return old_state;
+}
+
+/* Invalidate every other copy of block, for a write. Returns the core that held it modified, or -1. */
+static int invalidate_sharers(coherence_t *coherence, coh_block *entry, int core) {
+    uint64_t others = entry->sharers & ~CORE_BIT(core);
+    int supplier = -1;
+
+    while (others) {
+        int j = __builtin_ctzll(others);
+        int old_state = set_remote_state(&coherence->cores[j], entry->block, STATE_I);
+
+        others &= others - 1;
+        if (old_state == STATE_M || old_state == STATE_O || old_state == STATE_E)
+            supplier = j;
+        coherence->cores[j].stats.invalidations++;
+        entry->invalidated |= CORE_BIT(j);
+        if (coherence->interconnect == COH_DIRECTORY)
+            coherence->messages++;
+    }
+
+    entry->sharers &= CORE_BIT(core);
+    return supplier;
+}
+
+/* Downgrade the other copies of block for a read. Returns the core that supplies the data, or -1. */
+static int downgrade_sharers(coherence_t *coherence, coh_block *entry, int core) {
+    uint64_t others = entry->sharers & ~CORE_BIT(core);
+    int supplier = -1;
+
+    while (others) {
+        int j = __builtin_ctzll(others);
+        core_t *other = &coherence->cores[j];
+        cache_t *cache = &other->cache;
+        uint32_t set_index = entry->block % cache->num_sets;
+        int way = find_way(cache, set_index, entry->block / cache->num_sets);
+        int state = other->states[(size_t) set_index * cache->assoc + way];
+
+        others &= others - 1;
+        if (state == STATE_M && coherence->protocol == COH_MOESI) {
+            set_remote_state(other, entry->block, STATE_O);
+            supplier = j;
+        } else if (state == STATE_M) {
+            /* The flushed block updates memory on its way to the reader */
+            set_remote_state(other, entry->block, STATE_S);
+            coherence->mem_writes++;
+            supplier = j;
+        } else if (state == STATE_O) {
+            supplier = j;
+        } else if (state == STATE_E) {
+            set_remote_state(other, entry->block, STATE_S);
+            supplier = j;
+        }
+    }
+
+    if (supplier >= 0 && coherence->interconnect == COH_DIRECTORY)
+        coherence->messages++;
+    return supplier;
+}
+
+/* Evict the way chosen for block from core's set, writing back M and O copies */
+static void evict_way(coherence_t *coherence, int core, uint32_t set_index, int way) {
+    cache_t *cache = &coherence->cores[core].cache;
+    uint8_t *state = &coherence->cores[core].states[(size_t) set_index * cache->assoc + way];
+    uint32_t victim = block_addr(cache, set_index, way) / cache->block_size;
+
+    if (!TEST_WAY(SET_VALID(cache, set_index), way))
+        return;
+
+    find_block(coherence, victim)->sharers &= ~CORE_BIT(core);
+
+    if (*state == STATE_M || *state == STATE_O) {
+        cache->stats.write_backs++;
+        coherence->transactions++;
+        coherence->data_transfers++;
+        coherence->mem_writes++;
+    }
+    if (coherence->interconnect == COH_DIRECTORY)
+        coherence->messages++;
+    *state = STATE_I;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : coherence_access                                */
+/*                                                             */
+/* Purpose   : Simulate one read or write issued by core       */
+/*                                                             */
+/***************************************************************/
+void coherence_access(coherence_t *coherence, int core, uint32_t addr, bool is_read) {
+    core_t *self = &coherence->cores[core];
+    cache_t *cache = &self->cache;
+    uint32_t block = addr / cache->block_size;
+    uint32_t set_index = block % cache->num_sets;
+    uint32_t tag = block / cache->num_sets;
+    uint8_t *states = self->states + (size_t) set_index * cache->assoc;
+    int way = find_way(cache, set_index, tag);
+    coh_block *entry;
+    int supplier;
+    int new_state;
+
+    if (way >= 0) {
+        if (is_read) {
+            cache->stats.read_hits++;
+        } else {
+            cache->stats.write_hits++;
+            if (states[way] == STATE_S || states[way] == STATE_O) {
+                self->stats.upgrades++;
+                self->stats.bus_requests++;
+                coherence->transactions++;
+                if (coherence->interconnect == COH_SNOOP)
+                    coherence->snoops += coherence->num_cores - 1;
+                else
+                    coherence->messages++;
+                invalidate_sharers(coherence, find_block(coherence, block), core);
+            }
+            states[way] = STATE_M;
+            SET_DIRTY(cache, set_index)[way >> 6] |= WAY_BIT(way);
+        }
+
+        cache->policy->touch(SET_META(cache, set_index), cache->assoc, way, false, &cache->rng);
+        return;
+    }
+
+    if (is_read)
+        cache->stats.read_misses++;
+    else
+        cache->stats.write_misses++;
+
+    /* Evict first: the victim's table entry must be looked up before the table can grow */
+    way = get_victim_block(cache, set_index);
+    evict_way(coherence, core, set_index, way);
+
+    entry = lookup_block(coherence, block);
+    if (entry->invalidated & CORE_BIT(core))
+        self->stats.coherence_misses++;
+    entry->invalidated &= ~CORE_BIT(core);
+
+    self->stats.bus_requests++;
+    coherence->transactions++;
+    coherence->data_transfers++;
+    if (coherence->interconnect == COH_SNOOP)
+        coherence->snoops += coherence->num_cores - 1;
+    else
+        coherence->messages++;
+
+    if (is_read) {
+        supplier = downgrade_sharers(coherence, entry, core);
+        if (entry->sharers & ~CORE_BIT(core))
+            new_state = STATE_S;
+        else
+            new_state = (coherence->protocol == COH_MSI) ? STATE_S : STATE_E;
+    } else {
+        supplier = invalidate_sharers(coherence, entry, core);
+        new_state = STATE_M;
+    }
+
+    if (supplier >= 0)
+        coherence->cores[supplier].stats.interventions++;
+    else
+        coherence->mem_reads++;
+
+    entry->sharers |= CORE_BIT(core);
+    states[way] = new_state;
+    SET_VALID(cache, set_index)[way >> 6] |= WAY_BIT(way);
+    if (new_state == STATE_M)
+        SET_DIRTY(cache, set_index)[way >> 6] |= WAY_BIT(way);
+    else
+        SET_DIRTY(cache, set_index)[way >> 6] &= ~WAY_BIT(way);
+    SET_TAGS(cache, set_index)[way] = tag;
+    cache->policy->touch(SET_META(cache, set_index), cache->assoc, way, true, &cache->rng);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : coherence_report                                */
+/*                                                             */
+/* Purpose   : Dump each core's cache and coherence stats,     */
+/*             then the interconnect traffic                   */
+/*                                                             */
+/***************************************************************/
+void coherence_report(const coherence_t *coherence) {
+    static const char *protocol_titles[] = { "MSI", "MESI", "MOESI" };
+    static const char *interconnect_titles[] = { "snooping bus", "directory" };
+
+    printf("Coherence Configuration:\n");
+    printf("-------------------------------------\n");
+    printf("Cores: %d\n", coherence->num_cores);
+    printf("Protocol: %s\n", protocol_titles[coherence->protocol]);
+    printf("Interconnect: %s\n", interconnect_titles[coherence->interconnect]);
+    printf("\n");
+
+    for (int i = 0; i < coherence->num_cores; i++) {
+        const core_t *core = &coherence->cores[i];
+
+        printf("Core %d:\n", i);
+        printf("=====================================\n");
+        cache_report(&core->cache, false);
+
+        printf("Coherence Stat:\n");
+        printf("-------------------------------------\n");
+        printf("Coherence misses: %" PRIu64 "\n", core->stats.coherence_misses);
+        printf("Invalidations received: %" PRIu64 "\n", core->stats.invalidations);
+        printf("Upgrades: %" PRIu64 "\n", core->stats.upgrades);
+        printf("Interventions: %" PRIu64 "\n", core->stats.interventions);
+        printf("Bus requests: %" PRIu64 "\n", core->stats.bus_requests);
+        printf("\n");
+    }
+
+    printf("Interconnect Stat:\n");
+    printf("-------------------------------------\n");
+    printf("Transactions: %" PRIu64 "\n", coherence->transactions);
+    printf("Data transfers: %" PRIu64 " (%" PRIu64 "B)\n", coherence->data_transfers,
+           coherence->data_transfers * coherence->cores[0].cache.block_size);
+    if (coherence->interconnect == COH_SNOOP)
+        printf("Snoop lookups: %" PRIu64 "\n", coherence->snoops);
+    else
+        printf("Directory messages: %" PRIu64 "\n", coherence->messages);
+    printf("Memory reads: %" PRIu64 "\n", coherence->mem_reads);
+    printf("Memory writes: %" PRIu64 "\n", coherence->mem_writes);
+    printf("\n");
+}
+
+void coherence_free(coherence_t *coherence) {
+    for (int i = 0; i < coherence->num_cores; i++) {
+        cache_free(&coherence->cores[i].cache);
+        free(coherence->cores[i].states);
+    }
+
+    free(coherence->cores);
+    free(coherence->blocks);
+    memset(coherence, 0, sizeof(coherence_t));
+}
@@ -0,0 +1,86 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   coherence.h                                               */
+/*                                                             */
+/*   Private per-core caches kept coherent with MSI, MESI or   */
+/*   MOESI over a snooping bus or a directory.                 */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _COHERENCE_H_
+#define _COHERENCE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cache.h"
+
+#define COH_MAX_CORES		64	/* sharer sets are one uint64_t */
+
+#define COH_MSI			0
+#define COH_MESI		1
+#define COH_MOESI		2
+
+#define COH_SNOOP		0
+#define COH_DIRECTORY		1
+
+/* Line states, kept next to the tags of each core's cache */
+#define STATE_I			0
+#define STATE_S			1
+#define STATE_E			2
+#define STATE_O			3
+#define STATE_M			4
+
+typedef struct core_stats {
+    uint64_t coherence_misses;		/* misses to blocks lost to another core's write */
+    uint64_t invalidations;		/* copies removed here by other cores */
+    uint64_t upgrades;			/* writes to S/O copies that had to invalidate others */
+    uint64_t interventions;		/* blocks supplied to other cores */
+    uint64_t bus_requests;		/* read, read-exclusive and upgrade requests issued */
+} core_stats;
+
+/* One core: its private cache with counters, plus a state byte per way */
+typedef struct core_s {
+    cache_t cache;
+    uint8_t *states;			/* num_sets * assoc */
+    core_stats stats;
+} core_t;
+
+/* Which cores hold a block, and which lost it to an invalidation */
+typedef struct coh_block {
+    uint32_t block;
+    bool used;
+    uint64_t sharers;
+    uint64_t invalidated;
+} coh_block;
+
+typedef struct coherence_s {
+    int num_cores;
+    int protocol;
+    int interconnect;
+    core_t *cores;
+
+    coh_block *blocks;
+    uint32_t num_blocks;
+    uint32_t block_table_size;
+
+    /* interconnect traffic */
+    uint64_t transactions;		/* requests and write-backs on the bus or network */
+    uint64_t data_transfers;		/* blocks moved between caches or memory */
+    uint64_t snoops;			/* tag lookups in other caches (snooping) */
+    uint64_t messages;			/* point-to-point forwards and invalidations (directory) */
+    uint64_t mem_reads;
+    uint64_t mem_writes;
+} coherence_t;
+
+/* Functions */
+bool	parse_coherence_args(char *coherence_args, int *num_cores, int *protocol, int *interconnect);
+bool	coherence_init(coherence_t *coherence, int num_cores, int protocol, int interconnect,
+		       const cache_config *config);
+void	coherence_access(coherence_t *coherence, int core, uint32_t addr, bool is_read);
+void	coherence_report(const coherence_t *coherence);
+void	coherence_free(coherence_t *coherence);
+
+#endif
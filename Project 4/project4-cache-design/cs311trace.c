@@ -0,0 +1,157 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   cs311trace.c                                              */
+/*                                                             */
+/*   Converts "R 0x..." text traces to the binary format read  */
+/*   by cs311cache, binary traces back to text, and writes     */
+/*   synthetic traces.                                         */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <getopt.h>
+
+#include "trace.h"
+#include "gen.h"
+
+static void usage(const char *prog) {
+    printf("Error: usage: %s [-d] [-c] [-p] input_trace output_trace\n", prog);
+    printf("       %s -t binary_trace\n", prog);
+    printf("       %s -g stream|stride[:bytes]|random|zipf[:alpha]|chase|mix -n records -F footprint[K|M] "
+           "[-W write_percent] [-s seed] [-d] output_trace\n", prog);
+    exit(1);
+}
+
+/* Byte count with an optional K or M suffix */
+static uint32_t parse_size(const char *arg) {
+    char *end;
+    unsigned long value = strtoul(arg, &end, 10);
+
+    if (*end == 'K' || *end == 'k')
+        value <<= 10;
+    else if (*end == 'M' || *end == 'm')
+        value <<= 20;
+
+    return (uint32_t) value;
+}
+
+static void generate(const gen_config *config, uint64_t num_records, const char *path, uint32_t flags) {
+    trace_writer writer;
+    trace_record record;
+    gen_t gen;
+
+    if (!gen_init(&gen, config)) {
+        printf("Error: invalid generator configuration\n");
+        exit(1);
+    }
+    if (!trace_writer_open(&writer, path, flags)) {
+        printf("Error: Can't create trace file %s\n", path);
+        exit(1);
+    }
+
+    for (uint64_t i = 0; i < num_records; i++) {
+        gen_next(&gen, &record);
+        trace_write(&writer, &record);
+    }
+
+    trace_writer_close(&writer);
+    gen_free(&gen);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t flags = 0;
+    bool to_text = false;
+    bool generating = false;
+    gen_config gen_config;
+    uint64_t num_records = 0;
+    trace_reader reader;
+    trace_writer writer;
+    trace_record record;
+    int opt;
+
+    memset(&gen_config, 0, sizeof(gen_config));
+    gen_config.seed = 1;
+
+    while ((opt = getopt(argc, argv, "dcptg:n:F:W:s:")) != -1) {
+        switch (opt) {
+            case 'd':
+                flags |= TRACE_FLAG_DELTA;
+                break;
+            case 'c':
+                flags |= TRACE_FLAG_CORE;
+                break;
+            case 'p':
+                flags |= TRACE_FLAG_PC;
+                break;
+            case 't':
+                to_text = true;
+                break;
+            case 'g':
+                if (!parse_gen_args(optarg, &gen_config))
+                    usage(argv[0]);
+                generating = true;
+                break;
+            case 'n':
+                num_records = strtoull(optarg, NULL, 10);
+                break;
+            case 'F':
+                gen_config.footprint = parse_size(optarg);
+                break;
+            case 'W':
+                gen_config.write_percent = strtol(optarg, NULL, 10);
+                break;
+            case 's':
+                gen_config.seed = strtoull(optarg, NULL, 10);
+                break;
+            default:
+                usage(argv[0]);
+        }
+    }
+
+    if (generating) {
+        if (argc - optind != 1 || num_records == 0)
+            usage(argv[0]);
+        generate(&gen_config, num_records, argv[optind], flags);
+        return 0;
+    }
+
+    if (argc - optind != (to_text ? 1 : 2))
+        usage(argv[0]);
+
+    if (!trace_open(&reader, argv[optind])) {
+        printf("Error: Can't open trace file %s\n", argv[optind]);
+        exit(1);
+    }
+
+    if (to_text) {
+        while (trace_next(&reader, &record)) {
+            printf("%c 0x%x", record.is_fetch ? 'I' : record.is_read ? 'R' : 'W', record.addr);
+            if (reader.flags & TRACE_FLAG_CORE)
+                printf(" %d", record.core);
+            if (reader.flags & TRACE_FLAG_PC)
+                printf(" 0x%x", record.pc);
+            printf("\n");
+        }
+        trace_close(&reader);
+        return 0;
+    }
+
+    if (!trace_writer_open(&writer, argv[optind + 1], flags)) {
+        printf("Error: Can't create trace file %s\n", argv[optind + 1]);
+        exit(1);
+    }
+
+    while (trace_next(&reader, &record))
+        trace_write(&writer, &record);
+
+    trace_writer_close(&writer);
+    trace_close(&reader);
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   gen.c                                                     */
+/*                                                             */
+/*   Every generator draws from one xorshift64* stream, so a   */
+/*   pattern, footprint and seed always give the same trace.   */
+/*   Zipf draws binary-search a precomputed CDF of the item    */
+/*   ranks; the mix pattern switches between the other five    */
+/*   every GEN_MIX_RUN accesses.                               */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "gen.h"
+#include "replacement.h"
+
+static const char *gen_names[NUM_GEN] = { "stream", "stride", "random", "zipf", "chase", "mix" };
+
+int find_gen_pattern(const char *name) {
+    for (int i = 0; i < NUM_GEN; i++) {
+        if (strcmp(name, gen_names[i]) == 0)
+            return i;
+    }
+
+    return -1;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_gen_args                                  */
+/*                                                             */
+/* Purpose   : Parse pattern[:param], where param is the       */
+/*             stride in bytes for stride and the skew for     */
+/*             zipf, e.g. stride:4096 or zipf:1.2              */
+/*                                                             */
+/***************************************************************/
+bool parse_gen_args(char *gen_args, gen_config *config) {
+    char *colon = strchr(gen_args, ':');
+
+    if (colon)
+        *colon = '\0';
+    config->pattern = find_gen_pattern(gen_args);
+    config->stride = DEFAULT_GEN_STRIDE;
+    config->alpha = DEFAULT_GEN_ALPHA;
+
+    if (config->pattern < 0)
+        return false;
+    if (colon && config->pattern == GEN_STRIDE)
+        config->stride = strtoul(colon + 1, NULL, 10);
+    else if (colon && config->pattern == GEN_ZIPF)
+        config->alpha = strtod(colon + 1, NULL);
+    else if (colon)
+        return false;
+
+    return config->stride >= 1 && config->alpha >= 0;
+}
+
+static uint32_t random_below(gen_t *gen, uint32_t n) {
+    return (uint32_t) ((repl_random(&gen->rng) >> 32) * n >> 32);
+}
+
+/* Fisher-Yates over 0..n-1 */
+static uint32_t *shuffled(gen_t *gen, uint32_t n) {
+    uint32_t *order = (uint32_t *) malloc(sizeof(uint32_t) * n);
+
+    for (uint32_t i = 0; i < n; i++)
+        order[i] = i;
+    for (uint32_t i = n - 1; i > 0; i--) {
+        uint32_t j = random_below(gen, i + 1);
+        uint32_t t = order[i];
+
+        order[i] = order[j];
+        order[j] = t;
+    }
+
+    return order;
+}
+
+bool gen_init(gen_t *gen, const gen_config *config) {
+    bool needs_zipf = (config->pattern == GEN_ZIPF || config->pattern == GEN_MIX);
+    bool needs_chase = (config->pattern == GEN_CHASE || config->pattern == GEN_MIX);
+
+    memset(gen, 0, sizeof(gen_t));
+
+    if (config->pattern < 0 || config->pattern >= NUM_GEN || config->footprint < GEN_NODE_SIZE)
+        return false;
+    if (config->write_percent < 0 || config->write_percent > 100)
+        return false;
+    if ((uint64_t) GEN_BASE_ADDR + config->footprint > UINT32_MAX)
+        return false;
+
+    gen->config = *config;
+    if (gen->config.stride == 0)
+        gen->config.stride = DEFAULT_GEN_STRIDE;
+    gen->rng = config->seed ? config->seed : 1;
+    gen->num_elements = config->footprint / GEN_ELEMENT_SIZE;
+    gen->num_nodes = config->footprint / GEN_NODE_SIZE;
+
+    if (needs_zipf) {
+        double sum = 0;
+
+        gen->zipf_cdf = (double *) malloc(sizeof(double) * gen->num_nodes);
+        for (uint32_t i = 0; i < gen->num_nodes; i++) {
+            sum += 1.0 / pow(i + 1, config->alpha);
+            gen->zipf_cdf[i] = sum;
+        }
+        for (uint32_t i = 0; i < gen->num_nodes; i++)
+            gen->zipf_cdf[i] /= sum;
+        gen->zipf_node = shuffled(gen, gen->num_nodes);
+    }
+
+    /* Walking a shuffled order as a ring visits every node once per lap */
+    if (needs_chase) {
+        uint32_t *order = shuffled(gen, gen->num_nodes);
+
+        gen->chase_next = (uint32_t *) malloc(sizeof(uint32_t) * gen->num_nodes);
+        for (uint32_t i = 0; i < gen->num_nodes; i++)
+            gen->chase_next[order[i]] = order[(i + 1) % gen->num_nodes];
+        gen->chase_node = order[0];
+        free(order);
+    }
+
+    return true;
+}
+
+void gen_free(gen_t *gen) {
+    free(gen->zipf_cdf);
+    free(gen->zipf_node);
+    free(gen->chase_next);
+    memset(gen, 0, sizeof(gen_t));
+}
+
+static uint32_t zipf_node(gen_t *gen) {
+    double u = (repl_random(&gen->rng) >> 11) * (1.0 / 9007199254740992.0);
+    uint32_t lo = 0, hi = gen->num_nodes - 1;
+
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+
+        if (gen->zipf_cdf[mid] < u)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return gen->zipf_node[lo];
+}
+
+/* Byte offset of the next access into the footprint */
+static uint32_t next_offset(gen_t *gen, int pattern) {
+    uint32_t offset;
+
+    switch (pattern) {
+        case GEN_STREAM:
+        case GEN_STRIDE:
+            offset = gen->position;
+            gen->position += (pattern == GEN_STREAM) ? GEN_ELEMENT_SIZE : gen->config.stride;
+            if (gen->position >= gen->config.footprint)
+                gen->position %= gen->config.footprint;
+            return offset;
+        case GEN_RANDOM:
+            return random_below(gen, gen->num_elements) * GEN_ELEMENT_SIZE;
+        case GEN_ZIPF:
+            return zipf_node(gen) * GEN_NODE_SIZE;
+        case GEN_CHASE:
+            offset = gen->chase_node * GEN_NODE_SIZE;
+            gen->chase_node = gen->chase_next[gen->chase_node];
+            return offset;
+    }
+
+    return 0;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : gen_next                                        */
+/*                                                             */
+/* Purpose   : Produce the next access of the stream           */
+/*                                                             */
+/***************************************************************/
+void gen_next(gen_t *gen, trace_record *record) {
+    int pattern = gen->config.pattern;
+
+    if (pattern == GEN_MIX)
+        pattern = (gen->count / GEN_MIX_RUN) % GEN_MIX;
+
+    memset(record, 0, sizeof(trace_record));
+    record->addr = GEN_BASE_ADDR + next_offset(gen, pattern);
+    record->is_read = (random_below(gen, 100) >= (uint32_t) gen->config.write_percent);
+    gen->count++;
+}
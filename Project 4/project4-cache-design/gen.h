@@ -0,0 +1,70 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   gen.h                                                     */
+/*                                                             */
+/*   Synthetic access streams: sequential, strided, uniform    */
+/*   random, Zipfian, pointer-chasing and a mix of them, over  */
+/*   a footprint of configurable size.                         */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _GEN_H_
+#define _GEN_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "trace.h"
+
+#define GEN_STREAM	0
+#define GEN_STRIDE	1
+#define GEN_RANDOM	2
+#define GEN_ZIPF	3
+#define GEN_CHASE	4
+#define GEN_MIX		5
+#define NUM_GEN		6
+
+#define GEN_BASE_ADDR		0x10000000
+#define GEN_ELEMENT_SIZE	4	/* bytes per access */
+#define GEN_NODE_SIZE		64	/* bytes per pointer-chase node and Zipf item */
+#define GEN_MIX_RUN		64	/* accesses per pattern before a mix switches */
+#define DEFAULT_GEN_STRIDE	64
+#define DEFAULT_GEN_ALPHA	0.99
+
+typedef struct gen_config {
+    int pattern;
+    uint32_t footprint;		/* bytes touched, from GEN_BASE_ADDR */
+    uint32_t stride;		/* GEN_STRIDE: bytes between accesses, 0 for the default */
+    double alpha;		/* GEN_ZIPF: skew, 0 is uniform */
+    int write_percent;		/* share of accesses that are writes */
+    uint64_t seed;
+} gen_config;
+
+/*
+ * Zipf ranks and the chase order are shuffled over the footprint, so
+ * popular items and consecutive nodes are not neighbours in memory.
+ */
+typedef struct gen_s {
+    gen_config config;
+    uint64_t rng;
+    uint64_t count;
+    uint32_t num_elements;	/* footprint / GEN_ELEMENT_SIZE */
+    uint32_t num_nodes;		/* footprint / GEN_NODE_SIZE */
+
+    uint32_t position;		/* stream and stride cursor, in bytes */
+    double *zipf_cdf;		/* num_nodes entries, GEN_ZIPF and GEN_MIX */
+    uint32_t *zipf_node;	/* rank to node */
+    uint32_t *chase_next;	/* node to next node, one cycle through all */
+    uint32_t chase_node;
+} gen_t;
+
+/* Functions */
+int	find_gen_pattern(const char *name);
+bool	parse_gen_args(char *gen_args, gen_config *config);
+bool	gen_init(gen_t *gen, const gen_config *config);
+void	gen_next(gen_t *gen, trace_record *record);
+void	gen_free(gen_t *gen);
+
+#endif
@@ -0,0 +1,446 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   hierarchy.c                                               */
+/*                                                             */
+/*   Split L1 (instruction fetches go to L1I when present),    */
+/*   optional unified L2 and last-level cache, then memory.    */
+/*   Every level is a cache_t driven through the block-level   */
+/*   operations in cache.c, all from a single trace pass.      */
+/*                                                             */
+/*   A demand miss fetches the block from the next level, or   */
+/*   takes it out of an exclusive one. Dirty victims are       */
+/*   written back to the next level (allocating on a miss);    */
+/*   exclusive levels receive every victim from above, and an  */
+/*   inclusive level back-invalidates the levels above when it */
+/*   evicts.                                                   */
+/*                                                             */
+/*   Accesses carry the cycle they reach each level, so the    */
+/*   optional timing model can queue memory traffic behind     */
+/*   outstanding-miss slots and the bus.                       */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "hierarchy.h"
+
+static const char *level_names[NUM_LEVELS] = { "l1i", "l1d", "l2", "llc" };
+static const char *level_titles[NUM_LEVELS] = { "L1I", "L1D", "L2", "LLC" };
+static const int default_latencies[NUM_LEVELS] = { 4, 4, 12, 40 };
+static const char *inclusion_names[] = { "nine", "inclusive", "exclusive" };
+
+static int next_level(const hierarchy_t *hierarchy, int lvl) {
+    for (int i = (lvl < LEVEL_L2 ? LEVEL_L2 : lvl + 1); i < NUM_LEVELS; i++) {
+        if (hierarchy->levels[i].present)
+            return i;
+    }
+
+    return -1;
+}
+
+static void count_demand(cache_stats *stats, bool is_hit, bool is_write) {
+    if (is_hit) {
+        if (is_write)
+            stats->write_hits++;
+        else
+            stats->read_hits++;
+    } else {
+        if (is_write)
+            stats->write_misses++;
+        else
+            stats->read_misses++;
+    }
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_level_args                                */
+/*                                                             */
+/* Purpose   : Parse name=capacity:assoc:blocksize[:latency    */
+/*             [:inclusion[:policy]]], e.g.                    */
+/*             l2=262144:8:64:12:inclusive                     */
+/*                                                             */
+/***************************************************************/
+bool parse_level_args(char *level_args, hierarchy_t *hierarchy) {
+    char *equals = strchr(level_args, '=');
+    cache_level *level = NULL;
+    int level_arg_num = 0;
+    char *token;
+
+    if (equals == NULL)
+        return false;
+    *equals = '\0';
+
+    for (int i = 0; i < NUM_LEVELS; i++) {
+        if (strcmp(level_args, level_names[i]) == 0) {
+            level = &hierarchy->levels[i];
+            level->latency = default_latencies[i];
+        }
+    }
+    if (level == NULL)
+        return false;
+
+    level->present = true;
+    level->inclusion = INCL_NINE;
+    level->config.policy = REPL_LRU;
+    level->config.seed = 1;
+
+    token = strtok(equals + 1, ":");
+    while (token) {
+        switch (level_arg_num) {
+            case 0:
+                level->config.capacity = strtol(token, NULL, 10);
+                break;
+            case 1:
+                level->config.assoc = strtol(token, NULL, 10);
+                break;
+            case 2:
+                level->config.block_size = strtol(token, NULL, 10);
+                break;
+            case 3:
+                level->latency = strtol(token, NULL, 10);
+                break;
+            case 4:
+                level->inclusion = -1;
+                for (int i = INCL_NINE; i <= INCL_EXCLUSIVE; i++) {
+                    if (strcmp(token, inclusion_names[i]) == 0)
+                        level->inclusion = i;
+                }
+                if (level->inclusion < 0)
+                    return false;
+                break;
+            case 5:
+                level->config.policy = find_repl_policy(token);
+                if (level->config.policy < 0)
+                    return false;
+                break;
+        }
+
+        token = strtok(NULL, ":");
+        level_arg_num++;
+    }
+
+    return level_arg_num >= 3;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_timing_args                               */
+/*                                                             */
+/* Purpose   : Parse outstanding_misses:bus_bytes_per_cycle,   */
+/*             e.g. 8:16. Zero leaves either one unlimited.    */
+/*                                                             */
+/***************************************************************/
+bool parse_timing_args(char *timing_args, hierarchy_t *hierarchy) {
+    timing_t *timing = &hierarchy->timing;
+    char *colon = strchr(timing_args, ':');
+
+    timing->enabled = true;
+    timing->max_outstanding = strtol(timing_args, NULL, 10);
+    timing->bus_bandwidth = colon ? strtol(colon + 1, NULL, 10) : 0;
+
+    return timing->max_outstanding >= 0 && timing->max_outstanding <= MAX_OUTSTANDING && timing->bus_bandwidth >= 0;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : hierarchy_init                                  */
+/*                                                             */
+/* Purpose   : Allocate the configured levels. An L1D is       */
+/*             required and all levels share one block size.   */
+/*                                                             */
+/***************************************************************/
+bool hierarchy_init(hierarchy_t *hierarchy) {
+    int block_size = hierarchy->levels[LEVEL_L1D].config.block_size;
+
+    if (!hierarchy->levels[LEVEL_L1D].present)
+        return false;
+    if (hierarchy->mem_latency == 0)
+        hierarchy->mem_latency = DEFAULT_MEM_LATENCY;
+
+    for (int i = 0; i < NUM_LEVELS; i++) {
+        cache_level *level = &hierarchy->levels[i];
+
+        if (!level->present)
+            continue;
+        if (level->config.block_size != block_size || !cache_init(&level->cache, &level->config))
+            return false;
+        /* The L1s have nothing above them to include or exclude */
+        if (i <= LEVEL_L1D)
+            level->inclusion = INCL_NINE;
+    }
+
+    return true;
+}
+
+static uint64_t level_access(hierarchy_t *hierarchy, int lvl, uint32_t addr, bool is_write, uint64_t now);
+static void fill_level(hierarchy_t *hierarchy, int lvl, uint32_t addr, bool dirty, uint64_t now);
+
+static uint64_t transfer_cycles(const hierarchy_t *hierarchy) {
+    int bandwidth = hierarchy->timing.bus_bandwidth;
+
+    return (hierarchy->levels[LEVEL_L1D].config.block_size + bandwidth - 1) / bandwidth;
+}
+
+/* Read a block from memory; returns when it arrives */
+static uint64_t memory_read(hierarchy_t *hierarchy, uint64_t now) {
+    timing_t *timing = &hierarchy->timing;
+    uint64_t ready;
+    int slot = 0;
+
+    hierarchy->mem_reads++;
+    if (!timing->enabled)
+        return now + hierarchy->mem_latency;
+
+    if (timing->max_outstanding) {
+        for (int i = 1; i < timing->max_outstanding; i++) {
+            if (timing->slots[i] < timing->slots[slot])
+                slot = i;
+        }
+        if (timing->slots[slot] > now) {
+            timing->cur_outstanding += timing->slots[slot] - now;
+            now = timing->slots[slot];
+        }
+    }
+
+    ready = now + hierarchy->mem_latency;
+    timing->cur_memory += hierarchy->mem_latency;
+
+    /* The block crosses the bus at the end of the access, or as soon as the bus frees up */
+    if (timing->bus_bandwidth) {
+        uint64_t transfer = transfer_cycles(hierarchy);
+        uint64_t start = (ready > now + transfer) ? ready - transfer : now;
+
+        if (start < timing->bus_free)
+            start = timing->bus_free;
+        if (start + transfer > ready) {
+            timing->cur_bandwidth += start + transfer - ready;
+            ready = start + transfer;
+        }
+        timing->bus_free = start + transfer;
+    }
+
+    if (timing->max_outstanding)
+        timing->slots[slot] = ready;
+    return ready;
+}
+
+/* Write-backs leave through the write buffer; they only take bus time */
+static void memory_write(hierarchy_t *hierarchy, uint64_t now) {
+    timing_t *timing = &hierarchy->timing;
+
+    hierarchy->mem_writes++;
+    if (timing->enabled && timing->bus_bandwidth)
+        timing->bus_free = (timing->bus_free > now ? timing->bus_free : now) + transfer_cycles(hierarchy);
+}
+
+/* Send a block leaving lvl to the level below, or to memory */
+static void evict_block(hierarchy_t *hierarchy, int lvl, uint32_t addr, bool dirty, uint64_t now) {
+    int next = next_level(hierarchy, lvl);
+    cache_level *below;
+
+    if (dirty)
+        hierarchy->levels[lvl].cache.stats.write_backs++;
+
+    if (next < 0) {
+        if (dirty)
+            memory_write(hierarchy, now);
+        return;
+    }
+
+    below = &hierarchy->levels[next];
+    if (below->inclusion == INCL_EXCLUSIVE) {
+        /* Both L1s may have held the block; keep a single copy below */
+        if (!cache_lookup(&below->cache, addr, dirty))
+            fill_level(hierarchy, next, addr, dirty, now);
+        return;
+    }
+
+    if (dirty) {
+        bool is_hit = cache_lookup(&below->cache, addr, true);
+
+        count_demand(&below->cache.stats, is_hit, true);
+        if (!is_hit)
+            fill_level(hierarchy, next, addr, true, now);
+    }
+}
+
+static void fill_level(hierarchy_t *hierarchy, int lvl, uint32_t addr, bool dirty, uint64_t now) {
+    cache_level *level = &hierarchy->levels[lvl];
+    uint32_t victim;
+    bool victim_dirty;
+
+    if (!cache_insert(&level->cache, addr, dirty, &victim, &victim_dirty))
+        return;
+
+    if (level->inclusion == INCL_INCLUSIVE) {
+        for (int i = 0; i < lvl; i++) {
+            bool upper_dirty;
+
+            if (hierarchy->levels[i].present && cache_invalidate(&hierarchy->levels[i].cache, victim, &upper_dirty)) {
+                level->back_invalidations++;
+                victim_dirty |= upper_dirty;
+            }
+        }
+    }
+
+    evict_block(hierarchy, lvl, victim, victim_dirty, now);
+}
+
+/* Bring a block that missed at lvl up from below, starting at cycle now; returns when it arrives */
+static uint64_t fetch_block(hierarchy_t *hierarchy, int lvl, uint32_t addr, uint64_t now, bool *dirty) {
+    int next = next_level(hierarchy, lvl);
+    cache_level *below;
+    bool is_hit;
+
+    *dirty = false;
+    if (next < 0)
+        return memory_read(hierarchy, now);
+
+    below = &hierarchy->levels[next];
+    if (below->inclusion != INCL_EXCLUSIVE)
+        return level_access(hierarchy, next, addr, false, now);
+
+    /* Exclusive levels hand the block over */
+    now += below->latency;
+    is_hit = cache_invalidate(&below->cache, addr, dirty);
+    count_demand(&below->cache.stats, is_hit, false);
+    if (!is_hit)
+        now = fetch_block(hierarchy, next, addr, now, dirty);
+
+    return now;
+}
+
+static uint64_t level_access(hierarchy_t *hierarchy, int lvl, uint32_t addr, bool is_write, uint64_t now) {
+    cache_level *level = &hierarchy->levels[lvl];
+    bool is_hit = cache_lookup(&level->cache, addr, is_write);
+    bool dirty;
+
+    now += level->latency;
+    count_demand(&level->cache.stats, is_hit, is_write);
+    if (is_hit)
+        return now;
+
+    now = fetch_block(hierarchy, lvl, addr, now, &dirty);
+    fill_level(hierarchy, lvl, addr, dirty || is_write, now);
+    return now;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : hierarchy_access                                */
+/*                                                             */
+/* Purpose   : Simulate one CPU access through every level     */
+/*                                                             */
+/***************************************************************/
+void hierarchy_access(hierarchy_t *hierarchy, uint32_t addr, bool is_read, bool is_fetch) {
+    int l1 = (is_fetch && hierarchy->levels[LEVEL_L1I].present) ? LEVEL_L1I : LEVEL_L1D;
+    uint32_t block_size = hierarchy->levels[LEVEL_L1D].config.block_size;
+    timing_t *timing = &hierarchy->timing;
+    uint64_t start = timing->now;
+    uint64_t ready;
+
+    timing->cur_memory = timing->cur_bandwidth = timing->cur_outstanding = 0;
+    ready = level_access(hierarchy, l1, addr - addr % block_size, !is_read, start);
+    hierarchy->total_cycles += ready - start;
+    hierarchy->accesses++;
+
+    if (!timing->enabled)
+        return;
+
+    if (is_read) {
+        timing->memory_cycles += timing->cur_memory;
+        timing->bandwidth_stalls += timing->cur_bandwidth;
+        timing->outstanding_stalls += timing->cur_outstanding;
+        timing->cache_cycles += ready - start - timing->cur_memory - timing->cur_bandwidth - timing->cur_outstanding;
+        timing->now = ready;
+    } else {
+        /* A write only waits when its miss cannot get an outstanding-miss slot */
+        timing->outstanding_stalls += timing->cur_outstanding;
+        timing->write_cycles++;
+        timing->now = start + 1 + timing->cur_outstanding;
+    }
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : ldump                                           */
+/*                                                             */
+/* Purpose   : Dump the position of one level in the hierarchy */
+/*                                                             */
+/***************************************************************/
+static void ldump(const cache_level *level, int lvl) {
+    printf("Cache Level: %s\n", level_titles[lvl]);
+    printf("-------------------------------------\n");
+    printf("Hit latency: %d cycles\n", level->latency);
+    printf("Inclusion: %s\n", inclusion_names[level->inclusion]);
+    if (level->inclusion == INCL_INCLUSIVE)
+        printf("Back-invalidations: %" PRIu64 "\n", level->back_invalidations);
+    printf("\n");
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : tdump                                           */
+/*                                                             */
+/* Purpose   : Dump execution time and where it went. The      */
+/*             breakdown lines add up to the execution cycles. */
+/*                                                             */
+/***************************************************************/
+static void tdump(const timing_t *timing, uint64_t accesses) {
+    printf("Timing Stat:\n");
+    printf("-------------------------------------\n");
+    if (timing->max_outstanding)
+        printf("Outstanding misses: %d\n", timing->max_outstanding);
+    else
+        printf("Outstanding misses: unlimited\n");
+    if (timing->bus_bandwidth)
+        printf("Bus bandwidth: %dB/cycle\n", timing->bus_bandwidth);
+    else
+        printf("Bus bandwidth: unlimited\n");
+    printf("Execution cycles: %" PRIu64 "\n", timing->now);
+    printf("Cache latency: %" PRIu64 "\n", timing->cache_cycles);
+    printf("Memory latency: %" PRIu64 "\n", timing->memory_cycles);
+    printf("Bandwidth stalls: %" PRIu64 "\n", timing->bandwidth_stalls);
+    printf("Outstanding-miss stalls: %" PRIu64 "\n", timing->outstanding_stalls);
+    printf("Write issue: %" PRIu64 "\n", timing->write_cycles);
+    printf("Cycles per access: %.2f\n", accesses ? (double) timing->now / accesses : 0.0);
+    printf("\n");
+}
+
+void hierarchy_report(const hierarchy_t *hierarchy) {
+    for (int i = 0; i < NUM_LEVELS; i++) {
+        const cache_level *level = &hierarchy->levels[i];
+
+        if (!level->present)
+            continue;
+        ldump(level, i);
+        cache_report(&level->cache, false);
+    }
+
+    printf("Hierarchy Stat:\n");
+    printf("-------------------------------------\n");
+    printf("Memory latency: %d cycles\n", hierarchy->mem_latency);
+    printf("Memory reads: %" PRIu64 "\n", hierarchy->mem_reads);
+    printf("Memory writes: %" PRIu64 "\n", hierarchy->mem_writes);
+    printf("Total cycles: %" PRIu64 "\n", hierarchy->total_cycles);
+    printf("AMAT: %.2f cycles\n", hierarchy->accesses ? (double) hierarchy->total_cycles / hierarchy->accesses : 0.0);
+    printf("\n");
+
+    if (hierarchy->timing.enabled)
+        tdump(&hierarchy->timing, hierarchy->accesses);
+}
+
+void hierarchy_free(hierarchy_t *hierarchy) {
+    for (int i = 0; i < NUM_LEVELS; i++) {
+        if (hierarchy->levels[i].present)
+            cache_free(&hierarchy->levels[i].cache);
+    }
+}
@@ -0,0 +1,87 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   hierarchy.h                                               */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _HIERARCHY_H_
+#define _HIERARCHY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cache.h"
+
+#define LEVEL_L1I	0
+#define LEVEL_L1D	1
+#define LEVEL_L2	2
+#define LEVEL_LLC	3
+#define NUM_LEVELS	4
+
+/* How a level relates to the levels above it */
+#define INCL_NINE	0	/* non-inclusive, non-exclusive */
+#define INCL_INCLUSIVE	1	/* evictions back-invalidate the levels above */
+#define INCL_EXCLUSIVE	2	/* holds only blocks evicted from above */
+
+#define DEFAULT_MEM_LATENCY	200
+#define MAX_OUTSTANDING		64
+
+typedef struct cache_level {
+    bool present;
+    cache_config config;
+    cache_t cache;		/* cache.stats counts this level's demand reads and writes */
+    int latency;
+    int inclusion;
+    uint64_t back_invalidations;
+} cache_level;
+
+/*
+ * Optional timing model: an in-order core that waits for reads and
+ * fetches but retires writes into a write buffer. Memory reads need one
+ * of max_outstanding slots and every block moved to or from memory holds
+ * the bus for block_size / bus_bandwidth cycles. Zero means unlimited.
+ */
+typedef struct timing_s {
+    bool enabled;
+    int max_outstanding;
+    int bus_bandwidth;		/* bytes per cycle */
+
+    uint64_t now;
+    uint64_t bus_free;
+    uint64_t slots[MAX_OUTSTANDING];	/* completion time of each outstanding read */
+
+    /* the access being simulated */
+    uint64_t cur_memory;
+    uint64_t cur_bandwidth;
+    uint64_t cur_outstanding;
+
+    /* where execution cycles went */
+    uint64_t cache_cycles;
+    uint64_t memory_cycles;
+    uint64_t bandwidth_stalls;
+    uint64_t outstanding_stalls;
+    uint64_t write_cycles;
+} timing_t;
+
+typedef struct hierarchy_s {
+    cache_level levels[NUM_LEVELS];
+    int mem_latency;
+    timing_t timing;
+
+    uint64_t accesses;
+    uint64_t total_cycles;	/* sum of access latencies */
+    uint64_t mem_reads;
+    uint64_t mem_writes;
+} hierarchy_t;
+
+/* Functions */
+bool	parse_level_args(char *level_args, hierarchy_t *hierarchy);
+bool	parse_timing_args(char *timing_args, hierarchy_t *hierarchy);
+bool	hierarchy_init(hierarchy_t *hierarchy);
+void	hierarchy_access(hierarchy_t *hierarchy, uint32_t addr, bool is_read, bool is_fetch);
+void	hierarchy_report(const hierarchy_t *hierarchy);
+void	hierarchy_free(hierarchy_t *hierarchy);
+
+#endif
@@ -0,0 +1,202 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   kernel.c                                                  */
+/*                                                             */
+/*   cache_access() divides by the block size and set count    */
+/*   and loops over a runtime associativity. When both sizes   */
+/*   are powers of two and the associativity is 1, 2, 4, 8 or  */
+/*   16, a kernel instantiated for that associativity decodes  */
+/*   addresses with shifts and masks (folding in the XOR of    */
+/*   hashed indexing) and compares every tag of                */
+/*   the set without a loop bound; with LRU the rank update is */
+/*   inlined as well. Everything else, and any configuration   */
+/*   with a write policy, profile or miss stream that          */
+/*   cache_access() handles, replays through the generic loop. */
+/*                                                             */
+/*   Kernels change nothing but speed: hits, victims and       */
+/*   counters are those of cache_access().                     */
+/*                                                             */
+/***************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#endif
+
+#include "cache.h"
+#include "trace.h"
+#include "kernel.h"
+
+static bool specialized_kernels = true;
+
+void replay_generic(cache_t *cache, const trace_record *records, size_t num_records) {
+    for (size_t i = 0; i < num_records; i++)
+        cache_access(cache, records[i].addr, records[i].is_read);
+}
+
+/* Bit w set if way w holds tag; SSE2 is part of every x86-64 target, so no dispatch is needed */
+static inline __attribute__((always_inline)) uint32_t tag_match(const uint32_t *tags, uint32_t tag,
+                                                                const int assoc) {
+    uint32_t match = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (assoc >= 4) {
+        __m128i key = _mm_set1_epi32((int) tag);
+
+        for (int w = 0; w < assoc; w += 4) {
+            __m128i t = _mm_loadu_si128((const __m128i *) (tags + w));
+
+            match |= (uint32_t) _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(t, key))) << w;
+        }
+        return match;
+    }
+#endif
+    for (int w = 0; w < assoc; w++)
+        match |= (uint32_t) (tags[w] == tag) << w;
+
+    return match;
+}
+
+/* LRU ranks as in replacement.c, with the associativity known here */
+static inline __attribute__((always_inline)) void lru_update(uint16_t *lru, const int assoc, int way) {
+    uint16_t rank = lru[way];
+
+    for (int i = 0; i < assoc; i++)
+        lru[i] += (lru[i] < rank);
+    lru[way] = 0;
+}
+
+static inline __attribute__((always_inline)) int lru_oldest(const uint16_t *lru, const int assoc) {
+    int victim = 0;
+
+    for (int i = 0; i < assoc; i++) {
+        if (lru[i] == assoc - 1)
+            victim = i;
+    }
+
+    return victim;
+}
+
+/*
+ * The body every kernel is instantiated from; assoc and is_lru are
+ * constants in each instance. With at most 16 ways the valid and dirty
+ * masks are one word each, followed by the tags and the policy metadata.
+ */
+static inline __attribute__((always_inline)) void replay_pow2(cache_t *cache, const trace_record *records,
+                                                              size_t num_records, const int assoc,
+                                                              const bool is_lru) {
+    const int block_bits = __builtin_ctz(cache->block_size);
+    const int set_bits = __builtin_ctz(cache->num_sets);
+    const uint32_t set_mask = cache->num_sets - 1;
+    const uint32_t xor_mask = (cache->index == INDEX_XOR) ? set_mask : 0;
+    const uint32_t ways = (uint32_t) ((1u << assoc) - 1);
+    const repl_policy *policy = cache->policy;
+    cache_stats *stats = &cache->stats;
+
+    for (size_t i = 0; i < num_records; i++) {
+        uint32_t block_address = records[i].addr >> block_bits;
+        uint32_t tag = block_address >> set_bits;
+        uint32_t set_index = (block_address ^ (tag & xor_mask)) & set_mask;
+        uint64_t *valid = SET_VALID(cache, set_index);
+        uint64_t *dirty = valid + 1;
+        uint32_t *tags = (uint32_t *) (dirty + 1);
+        uint8_t *meta = (uint8_t *) (tags + assoc);
+        uint32_t match = tag_match(tags, tag, assoc) & (uint32_t) *valid;
+        bool is_read = records[i].is_read;
+        int way;
+
+        if (match) {
+            way = __builtin_ctz(match);
+            if (is_read)
+                stats->read_hits++;
+            else {
+                stats->write_hits++;
+                *dirty |= WAY_BIT(way);
+            }
+        } else {
+            uint32_t empty = ~(uint32_t) *valid & ways;
+
+            if (is_read)
+                stats->read_misses++;
+            else
+                stats->write_misses++;
+
+            if (empty)
+                way = __builtin_ctz(empty);
+            else if (is_lru)
+                way = lru_oldest((const uint16_t *) meta, assoc);
+            else
+                way = policy->victim(meta, assoc, &cache->rng);
+
+            if (*dirty & WAY_BIT(way))
+                stats->write_backs++;
+            *valid |= WAY_BIT(way);
+            if (is_read)
+                *dirty &= ~WAY_BIT(way);
+            else
+                *dirty |= WAY_BIT(way);
+            tags[way] = tag;
+        }
+
+        if (is_lru)
+            lru_update((uint16_t *) meta, assoc, way);
+        else
+            policy->touch(meta, assoc, way, !match, &cache->rng);
+    }
+}
+
+#define DEFINE_KERNELS(ASSOC) \
+    static void replay_lru_##ASSOC(cache_t *cache, const trace_record *records, size_t num_records) { \
+        replay_pow2(cache, records, num_records, ASSOC, true); \
+    } \
+    static void replay_any_##ASSOC(cache_t *cache, const trace_record *records, size_t num_records) { \
+        replay_pow2(cache, records, num_records, ASSOC, false); \
+    }
+
+DEFINE_KERNELS(1)
+DEFINE_KERNELS(2)
+DEFINE_KERNELS(4)
+DEFINE_KERNELS(8)
+DEFINE_KERNELS(16)
+
+/* Indexed by log2(assoc) */
+static const replay_kernel lru_kernels[] = { replay_lru_1, replay_lru_2, replay_lru_4, replay_lru_8, replay_lru_16 };
+static const replay_kernel any_kernels[] = { replay_any_1, replay_any_2, replay_any_4, replay_any_8, replay_any_16 };
+
+#define NUM_KERNELS	(sizeof(lru_kernels) / sizeof(lru_kernels[0]))
+
+static bool is_pow2(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : select_kernel                                   */
+/*                                                             */
+/* Purpose   : Pick the replay loop for a configuration once   */
+/*             it is initialized                               */
+/*                                                             */
+/***************************************************************/
+replay_kernel select_kernel(const cache_t *cache) {
+    int log_assoc = __builtin_ctz(cache->assoc);
+
+    if (!specialized_kernels || !is_pow2(cache->block_size) || !is_pow2(cache->num_sets) ||
+        !is_pow2(cache->assoc) || log_assoc >= (int) NUM_KERNELS)
+        return replay_generic;
+    /* cache_access() owns the write-through paths, the profile hooks, skewed caches and the miss stream */
+    if (cache->write_policy != WP_BACK || cache->profile || cache->skew || cache->filter)
+        return replay_generic;
+
+    if (cache->policy == &repl_policies[REPL_LRU])
+        return lru_kernels[log_assoc];
+    return any_kernels[log_assoc];
+}
+
+/* Off, every configuration initialized afterwards replays through cache_access() */
+void use_specialized_kernels(bool enable) {
+    specialized_kernels = enable;
+}
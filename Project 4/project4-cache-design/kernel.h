@@ -0,0 +1,28 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   kernel.h                                                  */
+/*                                                             */
+/*   Replay loops specialized for power-of-two geometries and  */
+/*   the common associativities, picked per configuration.     */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _KERNEL_H_
+#define _KERNEL_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+
+struct cache_s;
+struct trace_record;
+
+typedef void (*replay_kernel)(struct cache_s *cache, const struct trace_record *records, size_t num_records);
+
+/* Functions */
+replay_kernel	select_kernel(const struct cache_s *cache);
+void		use_specialized_kernels(bool enable);
+void		replay_generic(struct cache_s *cache, const struct trace_record *records, size_t num_records);
+
+#endif
@@ -0,0 +1,334 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   live.c                                                    */
+/*                                                             */
+/*   The shared-memory ring has one writer and one reader.     */
+/*   The writer fills records and publishes its head every     */
+/*   LIVE_PUBLISH_RECORDS records; the reader hands out runs   */
+/*   of published records in place and releases them by        */
+/*   advancing the tail when it asks for the next run. Each    */
+/*   side spins briefly, then yields, then sleeps while it     */
+/*   waits for the other, so an idle side costs little CPU.    */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "live.h"
+
+#define LIVE_RING_MAGIC		0x43533352	/* "CS3R" */
+#define LIVE_RETRY_NS		10000000	/* between attach attempts */
+#define LIVE_WRITER_CHECK	1024		/* waits between checks that the writer is alive */
+
+struct live_ring_shared {
+    _Atomic uint32_t ready;		/* LIVE_RING_MAGIC once the reader has set the ring up */
+    uint32_t capacity;
+    uint32_t record_size;		/* both sides must agree on trace_record */
+    _Atomic uint32_t closed;		/* set by the writer after publishing its last record */
+    _Atomic int32_t writer;		/* pid of the attached writer, 0 until one attaches */
+    _Alignas(64) _Atomic uint64_t head;	/* records published by the writer */
+    _Alignas(64) _Atomic uint64_t tail;	/* records released by the reader */
+    _Alignas(64) trace_record records[];
+};
+
+bool is_live_path(const char *path, const char *prefix) {
+    return strncmp(path, prefix, strlen(prefix)) == 0;
+}
+
+/* Spin, then yield, then sleep; spins counts the calls since the wait began */
+static void backoff(int *spins) {
+    struct timespec pause = { 0, 50000 };
+
+    if (++*spins < 64)
+        return;
+    if (*spins < 128)
+        sched_yield();
+    else
+        nanosleep(&pause, NULL);
+}
+
+static void retry_pause(void) {
+    struct timespec pause = { 0, LIVE_RETRY_NS };
+
+    nanosleep(&pause, NULL);
+}
+
+static bool unix_address(const char *path, struct sockaddr_un *addr) {
+    memset(addr, 0, sizeof(struct sockaddr_un));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path))
+        return false;
+    strcpy(addr->sun_path, path);
+    return true;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : live_accept                                     */
+/*                                                             */
+/* Purpose   : Listen on a Unix socket at path and wait for    */
+/*             one writer. Returns the connection, or -1.      */
+/*             The socket file is removed once connected.      */
+/*                                                             */
+/***************************************************************/
+int live_accept(const char *path) {
+    struct sockaddr_un addr;
+    int listener, fd;
+
+    if (!unix_address(path, &addr))
+        return -1;
+
+    listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        return -1;
+
+    unlink(path);
+    if (bind(listener, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(listener, 1) < 0) {
+        close(listener);
+        return -1;
+    }
+
+    do {
+        fd = accept(listener, NULL, NULL);
+    } while (fd < 0 && errno == EINTR);
+
+    close(listener);
+    unlink(path);
+    return fd;
+}
+
+/* Connect to a reader's socket, waiting up to LIVE_ATTACH_SECONDS for it to appear. Returns -1 on failure. */
+int live_connect(const char *path) {
+    struct sockaddr_un addr;
+    time_t deadline = time(NULL) + LIVE_ATTACH_SECONDS;
+
+    if (!unix_address(path, &addr))
+        return -1;
+
+    for (;;) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+        if (fd < 0)
+            return -1;
+        if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) == 0)
+            return fd;
+        close(fd);
+
+        if ((errno != ENOENT && errno != ECONNREFUSED) || time(NULL) >= deadline)
+            return -1;
+        retry_pause();
+    }
+}
+
+static size_t ring_size(uint32_t capacity) {
+    return sizeof(struct live_ring_shared) + sizeof(trace_record) * capacity;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : live_ring_create                                */
+/*                                                             */
+/* Purpose   : Create the shared-memory ring a reader consumes */
+/*             from, replacing a stale one of the same name.   */
+/*                                                             */
+/***************************************************************/
+live_ring *live_ring_create(const char *name) {
+    size_t size = ring_size(LIVE_RING_RECORDS);
+    live_ring *ring;
+    void *map;
+    int fd;
+
+    shm_unlink(name);
+    fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return NULL;
+    if (ftruncate(fd, size) < 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(name);
+        return NULL;
+    }
+
+    ring = (live_ring *) calloc(1, sizeof(live_ring));
+    ring->shared = (struct live_ring_shared *) map;
+    ring->map_size = size;
+    ring->name = strdup(name);
+
+    ring->shared->capacity = LIVE_RING_RECORDS;
+    ring->shared->record_size = sizeof(trace_record);
+    atomic_store_explicit(&ring->shared->ready, LIVE_RING_MAGIC, memory_order_release);
+    return ring;
+}
+
+/* Attach a writer to a reader's ring, waiting up to LIVE_ATTACH_SECONDS for it to be set up */
+live_ring *live_ring_attach(const char *name) {
+    time_t deadline = time(NULL) + LIVE_ATTACH_SECONDS;
+    struct live_ring_shared *shared;
+    live_ring *ring;
+    struct stat st;
+    size_t size;
+    int fd;
+
+    for (;;) {
+        fd = shm_open(name, O_RDWR, 0);
+        if (fd >= 0 && fstat(fd, &st) == 0 && (size_t) st.st_size >= sizeof(struct live_ring_shared))
+            break;
+        if (fd >= 0)
+            close(fd);
+        else if (errno != ENOENT)
+            return NULL;
+        if (time(NULL) >= deadline)
+            return NULL;
+        retry_pause();
+    }
+
+    size = st.st_size;
+    shared = (struct live_ring_shared *) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shared == MAP_FAILED)
+        return NULL;
+
+    while (atomic_load_explicit(&shared->ready, memory_order_acquire) != LIVE_RING_MAGIC) {
+        if (time(NULL) >= deadline) {
+            munmap(shared, size);
+            return NULL;
+        }
+        retry_pause();
+    }
+    if (shared->record_size != sizeof(trace_record) || size < ring_size(shared->capacity)) {
+        munmap(shared, size);
+        return NULL;
+    }
+
+    ring = (live_ring *) calloc(1, sizeof(live_ring));
+    ring->shared = shared;
+    ring->map_size = size;
+    ring->limit = atomic_load_explicit(&shared->tail, memory_order_acquire) + shared->capacity;
+    atomic_store_explicit(&shared->writer, getpid(), memory_order_relaxed);
+    return ring;
+}
+
+/* A writer that is gone without closing will never publish again; EPERM still means it exists */
+static bool writer_gone(struct live_ring_shared *shared) {
+    pid_t writer = atomic_load_explicit(&shared->writer, memory_order_relaxed);
+
+    return writer != 0 && kill(writer, 0) < 0 && errno == ESRCH;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : live_ring_next                                  */
+/*                                                             */
+/* Purpose   : Release the consumed records of the previous    */
+/*             run and wait for the next one. Returns its      */
+/*             length, or 0 once the writer has closed and     */
+/*             everything was read. A writer that exits        */
+/*             without closing also ends the stream, with an   */
+/*             error message.                                  */
+/*                                                             */
+/***************************************************************/
+size_t live_ring_next(live_ring *ring, const trace_record **records, size_t consumed) {
+    struct live_ring_shared *shared = ring->shared;
+    uint32_t mask = shared->capacity - 1;
+    size_t n;
+    int spins = 0;
+
+    if (consumed) {
+        ring->pos += consumed;
+        atomic_store_explicit(&shared->tail, ring->pos, memory_order_release);
+    }
+
+    while (ring->limit == ring->pos) {
+        /* The writer publishes its head before closing, so read closed first */
+        bool closed = atomic_load_explicit(&shared->closed, memory_order_acquire);
+
+        ring->limit = atomic_load_explicit(&shared->head, memory_order_acquire);
+        if (ring->limit == ring->pos) {
+            if (closed)
+                return 0;
+            /* The writer may have published and closed since the loads above, so look again once it is gone */
+            if (spins % LIVE_WRITER_CHECK == LIVE_WRITER_CHECK - 1 && writer_gone(shared) &&
+                !atomic_load_explicit(&shared->closed, memory_order_acquire) &&
+                atomic_load_explicit(&shared->head, memory_order_acquire) == ring->pos) {
+                printf("Error: trace writer %d exited without closing the ring\n",
+                       (int) atomic_load_explicit(&shared->writer, memory_order_relaxed));
+                return 0;
+            }
+            backoff(&spins);
+        }
+    }
+
+    /* Short runs let the writer refill the ring while they are replayed */
+    n = ring->limit - ring->pos;
+    if (n > TRACE_BLOCK_RECORDS)
+        n = TRACE_BLOCK_RECORDS;
+    if (n > shared->capacity - (ring->pos & mask))
+        n = shared->capacity - (ring->pos & mask);
+
+    *records = &shared->records[ring->pos & mask];
+    return n;
+}
+
+static void publish(live_ring *ring) {
+    atomic_store_explicit(&ring->shared->head, ring->pos, memory_order_release);
+    ring->published = ring->pos;
+}
+
+void live_ring_write(live_ring *ring, const trace_record *record) {
+    struct live_ring_shared *shared = ring->shared;
+    int spins = 0;
+
+    while (ring->pos == ring->limit) {
+        /* Full as far as we know: let the reader see everything, then look for released space */
+        if (ring->published != ring->pos)
+            publish(ring);
+        ring->limit = atomic_load_explicit(&shared->tail, memory_order_acquire) + shared->capacity;
+        if (ring->pos == ring->limit)
+            backoff(&spins);
+    }
+
+    shared->records[ring->pos & (shared->capacity - 1)] = *record;
+    ring->pos++;
+    if (ring->pos - ring->published >= LIVE_PUBLISH_RECORDS)
+        publish(ring);
+}
+
+/* A writer publishes what is left and marks the end; the reader removes the ring */
+void live_ring_close(live_ring *ring) {
+    if (ring == NULL)
+        return;
+
+    if (ring->name) {
+        shm_unlink(ring->name);
+        free(ring->name);
+    } else {
+        publish(ring);
+        atomic_store_explicit(&ring->shared->closed, 1, memory_order_release);
+    }
+
+    munmap(ring->shared, ring->map_size);
+    free(ring);
+}
@@ -0,0 +1,53 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   live.h                                                    */
+/*                                                             */
+/*   Traces written by a running process. Besides files and    */
+/*   FIFOs, a trace path may name a Unix socket (unix:path)    */
+/*   carrying the binary format, or a shared-memory ring of    */
+/*   records (shm:/name). cs311cache creates either one and    */
+/*   waits; the writer attaches to it.                         */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _LIVE_H_
+#define _LIVE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "trace.h"
+
+#define LIVE_UNIX_PREFIX	"unix:"
+#define LIVE_SHM_PREFIX		"shm:"
+
+#define LIVE_RING_RECORDS	(1 << 16)	/* power of two */
+#define LIVE_PUBLISH_RECORDS	256	/* writes made visible to the reader at a time */
+#define LIVE_ATTACH_SECONDS	10	/* how long a writer waits for the reader */
+
+struct live_ring_shared;
+
+/* One side's view of a ring. Each side keeps its position and the other's last published one. */
+typedef struct live_ring {
+    struct live_ring_shared *shared;
+    size_t map_size;
+    char *name;			/* set on the reader, which removes the ring */
+    uint64_t pos;		/* records written, or records released by the reader */
+    uint64_t published;		/* writer: pos as last made visible */
+    uint64_t limit;		/* writer: last tail + capacity; reader: last head */
+} live_ring;
+
+/* Functions */
+bool		is_live_path(const char *path, const char *prefix);
+int		live_accept(const char *path);
+int		live_connect(const char *path);
+live_ring*	live_ring_create(const char *name);
+live_ring*	live_ring_attach(const char *name);
+size_t		live_ring_next(live_ring *ring, const trace_record **records, size_t consumed);
+void		live_ring_write(live_ring *ring, const trace_record *record);
+void		live_ring_close(live_ring *ring);
+
+#endif
@@ -5,293 +5,537 @@
 #include <getopt.h>
 #include <stdbool.h>
 
-typedef struct block {
-    bool valid_bit;
-    bool dirty_bit;
-    uint32_t tag;
-    uint32_t addr;
-} cache_block;
-/***************************************************************/
-/*                                                             */
-/* Procedure : cdump                                           */
-/*                                                             */
-/* Purpose   : Dump cache configuration                        */
-/*                                                             */
-/***************************************************************/
-void cdump(int capacity, int assoc, int blocksize) {
-    printf("Cache Configuration:\n");
-    printf("-------------------------------------\n");
-    printf("Capacity: %dB\n", capacity);
-    printf("Associativity: %dway\n", assoc);
-    printf("Block Size: %dB\n", blocksize);
-    printf("\n");
+#include "cache.h"
+#include "trace.h"
+#include "sweep.h"
+#include "sdist.h"
+#include "hierarchy.h"
+#include "coherence.h"
+#include "prefetch.h"
+#include "miss.h"
+#include "sample.h"
+#include "profile.h"
+#include "checkpoint.h"
+#include "vm.h"
+
+static void usage(const char *prog) {
+    printf("Error: usage: %s [-c cap:assoc:bsize]... [-s cap_range:assoc_range:bsize_range] [-j threads] "
+           "[-r policy[,policy...]] [-i mod|xor|skew|z[:levels][,...]] [-p next|stride|stream|ghb[:degree]] [-v victim_entries] [-q mshrs[:latency]] "
+           "[-w back|back-noalloc|through|around] [-b write_buffer_depth] "
+           "[-S set:ratio|time:measure:warmup:period]... [-P top[:region_size]] [-o profile.csv|profile.json] "
+           "[-C] [-F miss_trace] [-K checkpoint[:every]] [-R checkpoint|-W checkpoint] [-V page_size [-t itlb|dtlb|stlb=entries:assoc[:policy]]...] "
+           "[-f text|csv] [-x] trace\n", prog);
+    printf("       %s -d min_cap-max_cap:assoc|fa:bsize [-f text|csv] [-H] trace\n", prog);
+    printf("       %s -l l1d=cap:assoc:bsize[:latency[:nine|inclusive|exclusive[:policy]]]... [-M mem_latency] [-T outstanding:bus_bytes] trace\n",
+           prog);
+    printf("       %s -m cores:msi|mesi|moesi[:snoop|dir] -c cap:assoc:bsize [-r policy] trace [trace...]\n", prog);
+    exit(1);
 }
 
-/***************************************************************/
-/*                                                             */
-/* Procedure : sdump                                           */
-/*                                                             */
-/* Purpose   : Dump cache stat		                       */
-/*                                                             */
-/***************************************************************/
-void sdump(int total_reads, int total_writes, int write_backs,
-           int reads_hits, int write_hits, int reads_misses, int write_misses) {
-    printf("Cache Stat:\n");
-    printf("-------------------------------------\n");
-    printf("Total reads: %d\n", total_reads);
-    printf("Total writes: %d\n", total_writes);
-    printf("Write-backs: %d\n", write_backs);
-    printf("Read hits: %d\n", reads_hits);
-    printf("Write hits: %d\n", write_hits);
-    printf("Read misses: %d\n", reads_misses);
-    printf("Write misses: %d\n", write_misses);
-    printf("\n");
-}
-
-/***************************************************************/
-/*                                                             */
-/* Procedure : xdump                                           */
-/*                                                             */
-/* Purpose   : Dump current cache state                        */
-/* 							       */
-/* Cache Design						       */
-/*  							       */
-/* 	    cache[set][assoc][word per block]		       */
-/*      						       */
-/*      						       */
-/*       ----------------------------------------	       */
-/*       I        I  way0  I  way1  I  way2  I                 */
-/*       ----------------------------------------              */
-/*       I        I  word0 I  word0 I  word0 I                 */
-/*       I  set0  I  word1 I  word1 I  work1 I                 */
-/*       I        I  word2 I  word2 I  word2 I                 */
-/*       I        I  word3 I  word3 I  word3 I                 */
-/*       ----------------------------------------              */
-/*       I        I  word0 I  word0 I  word0 I                 */
-/*       I  set1  I  word1 I  word1 I  work1 I                 */
-/*       I        I  word2 I  word2 I  word2 I                 */
-/*       I        I  word3 I  word3 I  word3 I                 */
-/*       ----------------------------------------              */
-/*      						       */
-/*                                                             */
-/***************************************************************/
-
-void xdump(int set, int way, cache_block **cache) {
-    int i, j, k = 0;
-
-    printf("Cache Content:\n");
-    printf("-------------------------------------\n");
-    for (i = 0; i < way; i++) {
-        if (i == 0) {
-            printf("    ");
-        }
-        printf("      WAY[%d]", i);
-    }
-    printf("\n");
+/* Profiles of every configuration go to one file, JSON if its name ends in .json */
+static void export_profiles(const char *path, const cache_t *caches, int num_caches) {
+    size_t len = strlen(path);
+    bool json = (len >= 5 && strcmp(path + len - 5, ".json") == 0);
+    FILE *fp = fopen(path, "w");
 
-    for (i = 0; i < set; i++) {
-        printf("SET[%d]:   ", i);
-        for (j = 0; j < way; j++) {
-            if (k != 0 && j == 0) {
-                printf("          ");
-            }
-            printf("0x%08x  ", cache[i][j].addr);
-        }
-        printf("\n");
+    if (fp == NULL) {
+        printf("Error: Can't open profile file %s\n", path);
+        exit(1);
     }
-    printf("\n");
-}
-
-void parse_cache_args(char *cache_args, int *capacity, int *assoc, int *block_size) {
-    int cache_arg_num = 0;
-    char *token;
-    token = strtok(cache_args, ":");
 
-    while (token) {
-        switch (cache_arg_num) {
-            case 0:
-                *capacity = strtol(token, NULL, 10);
-                break;
-            case 1:
-                *assoc = strtol(token, NULL, 10);
-                break;
-            case 2:
-                *block_size = strtol(token, NULL, 10);
-                break;
-        }
-
-        token = strtok(NULL, ":");
-        cache_arg_num++;
-    }
+    profile_export_header(fp, json);
+    for (int i = 0; i < num_caches; i++)
+        profile_export(fp, &caches[i], json, i == 0);
+    profile_export_footer(fp, json);
+    fclose(fp);
 }
 
-void parse_trace_args(char *trace_entry, bool *is_read_trace, uint32_t *trace_address) {
-    int trace_arg_num = 0;
-    char *token;
-    token = strtok(trace_entry, " ");
-
-    while (token) {
-        switch (trace_arg_num) {
-            case 0:
-                *is_read_trace = (token[0] == 'R');
-                break;
-            case 1:
-                *trace_address = strtol(token, NULL, 16);
-                break;
-        }
-
-        token = strtok(NULL, " ");
-        trace_arg_num++;
+static void save_checkpoint(const char *path, const cache_t *caches, int num_caches, uint64_t offset) {
+    if (!checkpoint_save(path, caches, num_caches, offset)) {
+        printf("Error: Can't write checkpoint %s\n", path);
+        exit(1);
     }
 }
 
-cache_block **allocate_cache(int num_sets, int associativity) {
-    cache_block **cache = (cache_block **) malloc(sizeof(cache_block *) * num_sets);
-    for (int i = 0; i < num_sets; i++) {
-        cache[i] = (cache_block *) malloc(sizeof(cache_block) * associativity);
+/*
+ * With a checkpoint path the trace is replayed every records at a time, saving after each run.
+ * With a vm the caches see translated addresses and page walks, and the TLBs are reported last.
+ */
+void process_traces(trace_reader *reader, vm_t *vm, cache_t *caches, int num_caches, int num_threads,
+                    bool print_cache, bool print_csv, const char *profile_path,
+                    const char *checkpoint_path, uint64_t checkpoint_every, uint64_t offset) {
+    if (checkpoint_path == NULL) {
+        sweep_run(reader, vm, caches, num_caches, num_threads, 0);
+    } else {
+        uint64_t n;
+
+        do {
+            n = sweep_run(reader, NULL, caches, num_caches, num_threads, checkpoint_every);
+            offset += n;
+            save_checkpoint(checkpoint_path, caches, num_caches, offset);
+        } while (checkpoint_every && n == checkpoint_every);
     }
-    for (int i = 0; i < num_sets; i++) {
-        for (int j = 0; j < associativity; j++)
-            memset(&cache[i][j], 0, sizeof(cache_block));
+    for (int i = 0; i < num_caches; i++) {
+        if (caches[i].sample)
+            sample_finish(&caches[i]);
     }
+    if (profile_path)
+        export_profiles(profile_path, caches, num_caches);
 
-    return cache;
-}
-
-uint32_t **allocate_page_access_table(int num_sets, int associativity) {
-    uint32_t **page_access_table = (uint32_t **) malloc(sizeof(uint32_t *) * num_sets);
+    if (print_csv)
+        cache_report_csv_header();
 
-    for (int i = 0; i < num_sets; i++) {
-        page_access_table[i] = (uint32_t *) malloc(sizeof(uint32_t) * associativity);
-    }
-    for (int i = 0; i < num_sets; i++) {
-        for (int j = 0; j < associativity; j++)
-            page_access_table[i][j] = 0;
+    for (int i = 0; i < num_caches; i++) {
+        if (print_csv)
+            cache_report_csv(&caches[i]);
+        else
+            cache_report(&caches[i], print_cache);
     }
-
-    return page_access_table;
+    if (vm && !print_csv)
+        vm_report(vm);
 }
 
-int get_victim_block(const cache_block *target_set, const uint32_t *page_entry, int assoc) {
-    int vic_index = 0;
-
-    for (int i = 0; i < assoc; i++) {
-        if (!target_set[i].valid_bit) {
-            vic_index = i;
-            break;
-        }
+void process_stack_distance(trace_reader *reader, sdist_t *sdist, bool print_csv, bool print_histogram) {
+    trace_record record;
 
-        if (page_entry[i] < page_entry[vic_index]) {
-            vic_index = i;
-        }
-    }
+    while (trace_next(reader, &record))
+        sdist_access(sdist, record.addr, record.is_read);
 
-    return vic_index;
+    sdist_report(sdist, print_csv, print_histogram);
 }
 
-void process_traces(cache_block **cache, uint32_t **page_access_table, int capacity, int assoc, int block_size,
-                    int num_sets, bool print_cache) {
-    char *trace_entry;
-    cache_block *target_set;
-    cache_block set_entry;
-    uint32_t *target_page_entry;
-    size_t trace_entry_length = 0;
-
-    uint32_t trace_address, aligned_addr, tag, block_offset, block_address, set_index;
-
-    static int total_operations;
-    static int read_hits, read_misses;
-    static int write_hits, write_misses;
-    static int total_write_backs;
-
-    while (getline(&trace_entry, &trace_entry_length, stdin) != -1) {
-        bool is_trace_read;
-        bool is_cache_hit = false;
-
-        parse_trace_args(trace_entry, &is_trace_read, &trace_address);
-        tag = (trace_address / num_sets) / block_size;
-        block_address = trace_address / block_size;
-        block_offset = trace_address % block_size;
-        aligned_addr = trace_address - block_offset;
-        set_index = block_address % num_sets;
-        target_set = cache[set_index];
-        target_page_entry = page_access_table[set_index];
-
-        for (int j = 0; j < assoc; j++) {
-            set_entry = target_set[j];
-
-            if (set_entry.valid_bit && (set_entry.tag == tag)) {
-                if (is_trace_read)
-                    read_hits++;
-
-                else {
-                    write_hits++;
-                    target_set[j].dirty_bit = true;
-                }
-
-                target_page_entry[j] = total_operations;
-                is_cache_hit = true;
-            }
-        }
-
-        if (!is_cache_hit) {
-
-            if (is_trace_read)
-                read_misses++;
-
-            else
-                write_misses++;
+void process_hierarchy(trace_reader *reader, hierarchy_t *hierarchy) {
+    trace_record record;
 
-            int victim_block = get_victim_block(target_set, target_page_entry, assoc);
+    while (trace_next(reader, &record))
+        hierarchy_access(hierarchy, record.addr, record.is_read, record.is_fetch);
 
-            if (target_set[victim_block].dirty_bit)
-                total_write_backs++;
+    hierarchy_report(hierarchy);
+}
 
-            target_set[victim_block].valid_bit = 1;
-            target_set[victim_block].dirty_bit = !is_trace_read;
-            target_set[victim_block].tag = tag;
-            target_set[victim_block].addr = aligned_addr;
-            target_page_entry[victim_block] = total_operations;
+/* One trace per core is replayed round-robin; a single trace is tagged with core IDs */
+void process_coherence(trace_reader *readers, int num_readers, coherence_t *coherence) {
+    trace_record record;
+    int active = num_readers;
+
+    while (active > 0) {
+        active = 0;
+        for (int i = 0; i < num_readers; i++) {
+            if (!trace_next(&readers[i], &record))
+                continue;
+            active++;
+
+            if (num_readers > 1)
+                record.core = i;
+            if (record.core >= coherence->num_cores) {
+                printf("Error: trace access from core %d, but only %d cores are simulated\n", record.core,
+                       coherence->num_cores);
+                exit(1);
+            }
+            coherence_access(coherence, record.core, record.addr, record.is_read);
         }
-        total_operations++;
     }
 
-    cdump(capacity, assoc, block_size);
-    sdump((read_hits + read_misses), (write_hits + write_misses), total_write_backs, read_hits, write_hits, read_misses, write_misses);
-
-    if (print_cache)
-        xdump(num_sets, assoc, cache);
+    coherence_report(coherence);
 }
 
-
 int main(int argc, char *argv[]) {
     bool print_cache = false;
-    cache_block **cache;
-    uint32_t **page_access_timestamps;
-
-    int capacity, associativity, block_size, num_sets;
+    bool print_csv = false;
+    bool print_histogram = false;
+    bool stack_distance = false;
+    bool use_hierarchy = false;
+    bool use_coherence = false;
+    bool use_vm = false;
+    int num_cores, protocol, interconnect;
+    hierarchy_t hierarchy;
+    vm_t vm;
+    trace_reader reader;
+    config_list configs;
+    cache_t *caches;
+
+    int capacity, associativity, block_size;
+    int min_capacity, max_capacity;
+    char *policy_args = NULL;
+    char *index_args = NULL;
+    int prefetcher = PF_NONE, prefetch_degree = 0;
+    int victim_entries = 0, mshrs = 0, mshr_latency = 0;
+    int write_policy = WP_BACK, wcb_depth = 0;
+    bool report_writes = false;
+    int sample_ratio = 0;
+    uint64_t sample_measure = 0, sample_warmup = 0, sample_period = 0;
+    int profile_top = 0, profile_region = 0;
+    char *profile_path = NULL;
+    bool classify = false;
+    char *filter_path = NULL;
+    trace_writer filter;
+    char *checkpoint_path = NULL, *resume_path = NULL;
+    uint64_t checkpoint_every = 0, offset = 0;
+    bool warm_start = false;
+    int num_threads = 1;
     int opt;
 
+    memset(&configs, 0, sizeof(config_list));
+    memset(&hierarchy, 0, sizeof(hierarchy_t));
+    memset(&vm, 0, sizeof(vm_t));
 
-    while ((opt = getopt(argc, argv, "c:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "c:s:d:l:M:T:m:r:i:p:v:q:w:b:S:P:o:CF:K:R:W:V:t:j:f:xH")) != -1) {
         switch (opt) {
             case 'c': {
+                capacity = associativity = block_size = 0;
                 parse_cache_args(optarg, &capacity, &associativity, &block_size);
+                add_config(&configs, capacity, associativity, block_size);
+                break;
+            }
+            case 's': {
+                if (!parse_sweep_args(optarg, &configs))
+                    usage(argv[0]);
+                break;
+            }
+            case 'd': {
+                if (!parse_sdist_args(optarg, &min_capacity, &max_capacity, &associativity, &block_size))
+                    usage(argv[0]);
+                stack_distance = true;
+                break;
+            }
+            case 'l': {
+                if (!parse_level_args(optarg, &hierarchy))
+                    usage(argv[0]);
+                use_hierarchy = true;
+                break;
+            }
+            case 'M': {
+                hierarchy.mem_latency = strtol(optarg, NULL, 10);
+                break;
+            }
+            case 'T': {
+                if (!parse_timing_args(optarg, &hierarchy))
+                    usage(argv[0]);
+                break;
+            }
+            case 'm': {
+                if (!parse_coherence_args(optarg, &num_cores, &protocol, &interconnect))
+                    usage(argv[0]);
+                use_coherence = true;
+                break;
+            }
+            case 'r': {
+                policy_args = optarg;
+                break;
+            }
+            case 'i': {
+                index_args = optarg;
+                break;
+            }
+            case 'p': {
+                if (!parse_prefetch_args(optarg, &prefetcher, &prefetch_degree))
+                    usage(argv[0]);
+                break;
+            }
+            case 'v': {
+                victim_entries = strtol(optarg, NULL, 10);
+                if (victim_entries < 1)
+                    usage(argv[0]);
+                break;
+            }
+            case 'q': {
+                if (!parse_mshr_args(optarg, &mshrs, &mshr_latency))
+                    usage(argv[0]);
+                break;
+            }
+            case 'w': {
+                write_policy = parse_write_policy(optarg);
+                if (write_policy < 0)
+                    usage(argv[0]);
+                report_writes = true;
+                break;
+            }
+            case 'b': {
+                wcb_depth = strtol(optarg, NULL, 10);
+                if (wcb_depth < 1)
+                    usage(argv[0]);
+                break;
+            }
+            case 'S': {
+                if (!parse_sample_args(optarg, &sample_ratio, &sample_measure, &sample_warmup, &sample_period))
+                    usage(argv[0]);
+                break;
+            }
+            case 'P': {
+                if (!parse_profile_args(optarg, &profile_top, &profile_region))
+                    usage(argv[0]);
+                break;
+            }
+            case 'o': {
+                profile_path = optarg;
+                break;
+            }
+            case 'C': {
+                classify = true;
+                break;
+            }
+            case 'F': {
+                filter_path = optarg;
+                break;
+            }
+            case 'K': {
+                if (!parse_checkpoint_args(optarg, &checkpoint_path, &checkpoint_every))
+                    usage(argv[0]);
+                break;
+            }
+            case 'R':
+            case 'W': {
+                resume_path = optarg;
+                warm_start = (opt == 'W');
+                break;
+            }
+            case 'V': {
+                if (!parse_vm_args(optarg, &vm))
+                    usage(argv[0]);
+                use_vm = true;
+                break;
+            }
+            case 't': {
+                if (!parse_tlb_args(optarg, &vm))
+                    usage(argv[0]);
+                break;
+            }
+            case 'H': {
+                print_histogram = true;
+                break;
+            }
+            case 'j': {
+                num_threads = strtol(optarg, NULL, 10);
+                break;
+            }
+            case 'f': {
+                print_csv = (strcmp(optarg, "csv") == 0);
                 break;
             }
             case 'x': {
                 print_cache = true;
                 break;
             }
+            default:
+                usage(argv[0]);
+        }
+    }
+
+    if ((configs.num_configs == 0 && !stack_distance && !use_hierarchy) || optind >= argc)
+        usage(argv[0]);
+
+    /* Policies apply to every configuration, so expand them once all -c/-s are known */
+    if (policy_args && !parse_policy_args(policy_args, &configs))
+        usage(argv[0]);
+    if (index_args && !parse_index_args(index_args, &configs))
+        usage(argv[0]);
+    if (index_args && (stack_distance || use_hierarchy || use_coherence)) {
+        printf("Error: -i only applies to -c and -s\n");
+        exit(1);
+    }
+    /* Every core gets a copy of one plain cache; the coherence engine has no other cache paths */
+    if (use_coherence && (configs.num_configs != 1 || prefetcher != PF_NONE || victim_entries > 0 || mshrs > 0 ||
+                          report_writes || wcb_depth > 0 || sample_ratio > 1 || sample_period > 0 ||
+                          profile_top > 0 || profile_path || classify || checkpoint_path || resume_path)) {
+        printf("Error: -m simulates exactly one -c configuration, and can't be combined with "
+               "-p, -v, -q, -w, -b, -S, -P, -o, -C, -K, -R or -W\n");
+        exit(1);
+    }
+    /* Stack distances and the hierarchy run engines of their own, which take none of the -c options */
+    if ((stack_distance || use_hierarchy) &&
+        (policy_args || prefetcher != PF_NONE || victim_entries > 0 || mshrs > 0 || report_writes || wcb_depth > 0 ||
+         sample_ratio > 1 || sample_period > 0 || profile_top > 0 || profile_path || classify || checkpoint_path ||
+         resume_path)) {
+        printf("Error: -d and -l can't be combined with -r, -p, -v, -q, -w, -b, -S, -P, -o, -C, -K, -R or -W\n");
+        exit(1);
+    }
+    /* A skewed cache has no sets for the policies, victim cache, MSHRs, write paths or profile to work on */
+    for (int i = 0; i < configs.num_configs; i++) {
+        if (configs.configs[i].index >= INDEX_SKEW &&
+            (configs.configs[i].policy != REPL_LRU || prefetcher != PF_NONE || victim_entries > 0 || mshrs > 0 ||
+             write_policy != WP_BACK || wcb_depth > 0 || sample_ratio > 1 || sample_period > 0 || profile_top > 0 ||
+             profile_path)) {
+            printf("Error: skewed caches and zcaches only replace by LRU and can't be combined with "
+                   "-p, -v, -q, -w, -b, -S, -P or -o\n");
+            exit(1);
+        }
+    }
+    /* The victim cache path moves whole blocks and always allocates */
+    if (victim_entries > 0 && write_policy != WP_BACK) {
+        printf("Error: a victim cache needs the write-back write policy\n");
+        exit(1);
+    }
+    /* Warm-up only restores the cache's own counters, and the shadow of -C must see every access */
+    if ((sample_ratio > 1 || sample_period > 0) &&
+        (prefetcher != PF_NONE || victim_entries > 0 || mshrs > 0 || wcb_depth > 0 || classify)) {
+        printf("Error: sampling can't be combined with -p, -v, -q, -b or -C\n");
+        exit(1);
+    }
+    /* An export without -P still needs the counters */
+    if (profile_path && profile_region == 0)
+        profile_region = DEFAULT_PROFILE_REGION;
+    /* The victim cache and MSHR paths bypass cache_access() */
+    if (profile_region > 0 && (victim_entries > 0 || mshrs > 0)) {
+        printf("Error: profiling can't be combined with -v or -q\n");
+        exit(1);
+    }
+    /* Warm-up accesses restore the cache's counters but not the profile's */
+    if (profile_region > 0 && sample_period > 0) {
+        printf("Error: profiling can't be combined with -S time\n");
+        exit(1);
+    }
+    /* Checkpoint offsets and sampling count trace records, which translation expands */
+    if (use_vm && (stack_distance || use_hierarchy || use_coherence || sample_ratio > 1 || sample_period > 0 ||
+                   checkpoint_path || resume_path)) {
+        printf("Error: -V only applies to -c and -s, and can't be combined with -S, -K, -R or -W\n");
+        exit(1);
+    }
+    /*
+     * The miss stream is the traffic below one configuration in trace order. Victim caches, MSHRs
+     * and prefetchers add transfers of their own, a write buffer merges stores, sampling sees only
+     * some sets, and a resumed run would start the stream midway.
+     */
+    if (filter_path && (configs.num_configs != 1 || stack_distance || use_hierarchy || use_coherence ||
+                        prefetcher != PF_NONE || victim_entries > 0 || mshrs > 0 || wcb_depth > 0 ||
+                        sample_ratio > 1 || sample_period > 0 || checkpoint_path || resume_path)) {
+        printf("Error: -F writes the miss stream of exactly one configuration, and can't be combined with "
+               "-p, -v, -q, -b, -S, -K, -R or -W\n");
+        exit(1);
+    }
+    if (use_vm && !vm_init(&vm)) {
+        printf("Error: invalid TLB configuration (a dtlb is required)\n");
+        exit(1);
+    }
+    for (int i = 0; i < configs.num_configs; i++) {
+        configs.configs[i].prefetcher = prefetcher;
+        configs.configs[i].prefetch_degree = prefetch_degree;
+        configs.configs[i].victim_entries = victim_entries;
+        configs.configs[i].mshrs = mshrs;
+        configs.configs[i].mshr_latency = mshr_latency;
+        configs.configs[i].write_policy = write_policy;
+        configs.configs[i].wcb_depth = wcb_depth;
+        configs.configs[i].report_writes = report_writes;
+        configs.configs[i].sample_ratio = sample_ratio;
+        configs.configs[i].sample_measure = sample_measure;
+        configs.configs[i].sample_warmup = sample_warmup;
+        configs.configs[i].sample_period = sample_period;
+        configs.configs[i].profile_top = profile_top;
+        configs.configs[i].profile_region = profile_region;
+        configs.configs[i].classify = classify;
+        configs.configs[i].walk_stats = use_vm;
+        configs.configs[i].filter = filter_path ? &filter : NULL;
+    }
+
+    if (use_coherence) {
+        int num_readers = argc - optind;
+        trace_reader *readers = (trace_reader *) calloc(num_readers, sizeof(trace_reader));
+        coherence_t coherence;
+
+        if (num_readers > num_cores)
+            usage(argv[0]);
+        for (int i = 0; i < num_readers; i++) {
+            if (!trace_open(&readers[i], argv[optind + i])) {
+                printf("Error: Can't open trace file %s\n", argv[optind + i]);
+                exit(1);
+            }
+        }
+
+        if (!coherence_init(&coherence, num_cores, protocol, interconnect, &configs.configs[0])) {
+            printf("Error: invalid cache configuration %d:%d:%d\n", configs.configs[0].capacity,
+                   configs.configs[0].assoc, configs.configs[0].block_size);
+            exit(1);
+        }
+        process_coherence(readers, num_readers, &coherence);
+
+        coherence_free(&coherence);
+        for (int i = 0; i < num_readers; i++)
+            trace_close(&readers[i]);
+        free(readers);
+        free(configs.configs);
+        return 0;
+    }
+
+    if (!trace_open(&reader, argv[argc - 1])) {
+        printf("Error: Can't open trace file %s\n", argv[argc - 1]);
+        exit(1);
+    }
+
+    if (stack_distance) {
+        sdist_t sdist;
+
+        if (!sdist_init(&sdist, min_capacity, max_capacity, associativity, block_size)) {
+            printf("Error: invalid stack distance range\n");
+            exit(1);
+        }
+        process_stack_distance(&reader, &sdist, print_csv, print_histogram);
+        sdist_free(&sdist);
+        trace_close(&reader);
+        return 0;
+    }
+
+    if (use_hierarchy) {
+        if (!hierarchy_init(&hierarchy)) {
+            printf("Error: invalid cache hierarchy (an l1d level and one block size are required)\n");
+            exit(1);
+        }
+        process_hierarchy(&reader, &hierarchy);
+        hierarchy_free(&hierarchy);
+        trace_close(&reader);
+        return 0;
+    }
+
+    /* Deltas between misses stay small, so the stream is delta coded */
+    if (filter_path && !trace_writer_open(&filter, filter_path, TRACE_FLAG_DELTA)) {
+        printf("Error: Can't create trace file %s\n", filter_path);
+        exit(1);
+    }
+
+    caches = (cache_t *) calloc(configs.num_configs, sizeof(cache_t));
+    for (int i = 0; i < configs.num_configs; i++) {
+        cache_config *config = &configs.configs[i];
+
+        if (!cache_init(&caches[i], config)) {
+            printf("Error: invalid cache configuration %d:%d:%d (%s)\n", config->capacity, config->assoc,
+                   config->block_size, repl_policies[config->policy].name);
+            exit(1);
         }
     }
 
-    freopen(argv[argc - 1], "r", stdin);
+    if (checkpoint_path || resume_path) {
+        for (int i = 0; i < configs.num_configs; i++) {
+            if (!checkpoint_supported(&caches[i])) {
+                printf("Error: checkpoints can't be combined with -p, -v, -q, -b, -S, -P, -o, -C or -i\n");
+                exit(1);
+            }
+        }
+    }
+    /* A warm start takes only the content; counting and the trace start over */
+    if (resume_path) {
+        if (!checkpoint_load(resume_path, caches, configs.num_configs, &offset, !warm_start)) {
+            printf("Error: Can't resume from checkpoint %s (missing, corrupt or other configurations)\n",
+                   resume_path);
+            exit(1);
+        }
+        if (warm_start)
+            offset = 0;
+        else if (trace_skip(&reader, offset) != offset) {
+            printf("Error: trace %s is shorter than the checkpoint offset\n", argv[argc - 1]);
+            exit(1);
+        }
+    }
 
-    num_sets = (capacity / associativity) / block_size;
-    cache = allocate_cache(num_sets, associativity);
-    page_access_timestamps = allocate_page_access_table(num_sets, associativity);
-    process_traces(cache, page_access_timestamps, capacity, associativity, block_size, num_sets, print_cache);
+    process_traces(&reader, use_vm ? &vm : NULL, caches, configs.num_configs, num_threads, print_cache, print_csv,
+                   profile_path, checkpoint_path, checkpoint_every, offset);
+    trace_close(&reader);
+    if (filter_path)
+        trace_writer_close(&filter);
+
+    for (int i = 0; i < configs.num_configs; i++)
+        cache_free(&caches[i]);
+    free(caches);
+    if (use_vm)
+        vm_free(&vm);
+    free(configs.configs);
 
     return 0;
 }
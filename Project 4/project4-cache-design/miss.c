@@ -0,0 +1,244 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   miss.c                                                    */
+/*                                                             */
+/*   With a victim cache the main cache is driven through its  */
+/*   block-level operations, so its evictions can be caught.   */
+/*   The main cache still fills every block it misses on, so   */
+/*   its hits and misses are the same as without the victim   */
+/*   cache; what changes is where the block comes from.        */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "cache.h"
+#include "miss.h"
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_mshr_args                                 */
+/*                                                             */
+/* Purpose   : Parse entries[:latency], e.g. 8:200             */
+/*                                                             */
+/***************************************************************/
+bool parse_mshr_args(char *mshr_args, int *num_entries, int *latency) {
+    char *colon = strchr(mshr_args, ':');
+
+    *latency = DEFAULT_MSHR_LATENCY;
+    if (colon)
+        *latency = strtol(colon + 1, NULL, 10);
+    *num_entries = strtol(mshr_args, NULL, 10);
+
+    return *num_entries >= 1 && *latency >= 1;
+}
+
+victim_cache *victim_create(const cache_t *cache, int num_entries) {
+    victim_cache *victim = (victim_cache *) calloc(1, sizeof(victim_cache));
+    cache_config config;
+
+    memset(&config, 0, sizeof(cache_config));
+    config.capacity = num_entries * cache->block_size;
+    config.assoc = num_entries;
+    config.block_size = cache->block_size;
+    config.policy = REPL_LRU;
+    config.seed = 1;
+
+    victim->cache = (cache_t *) malloc(sizeof(cache_t));
+    if (!cache_init(victim->cache, &config)) {
+        free(victim->cache);
+        free(victim);
+        return NULL;
+    }
+
+    return victim;
+}
+
+void victim_free(victim_cache *victim) {
+    if (victim == NULL)
+        return;
+
+    cache_free(victim->cache);
+    free(victim->cache);
+    free(victim);
+}
+
+mshr_file *mshr_create(int num_entries, int latency) {
+    mshr_file *mshr = (mshr_file *) calloc(1, sizeof(mshr_file));
+
+    mshr->num_entries = num_entries;
+    mshr->latency = latency;
+    mshr->entries = (mshr_entry *) calloc(num_entries, sizeof(mshr_entry));
+    return mshr;
+}
+
+void mshr_free(mshr_file *mshr) {
+    if (mshr == NULL)
+        return;
+
+    free(mshr->entries);
+    free(mshr);
+}
+
+static void mshr_retire(mshr_file *mshr) {
+    for (int i = 0; i < mshr->in_use; ) {
+        if (mshr->entries[i].ready <= mshr->now)
+            mshr->entries[i] = mshr->entries[--mshr->in_use];
+        else
+            i++;
+    }
+}
+
+static int mshr_find(const mshr_file *mshr, uint32_t block) {
+    for (int i = 0; i < mshr->in_use; i++) {
+        if (mshr->entries[i].block == block)
+            return i;
+    }
+
+    return -1;
+}
+
+/* A miss to memory: merge, allocate, or wait for the oldest fill when all entries are busy */
+static void mshr_miss(mshr_file *mshr, uint32_t block) {
+    if (mshr_find(mshr, block) >= 0) {
+        mshr->merges++;
+        return;
+    }
+
+    if (mshr->in_use == mshr->num_entries) {
+        uint64_t oldest = mshr->entries[0].ready;
+
+        for (int i = 1; i < mshr->in_use; i++) {
+            if (mshr->entries[i].ready < oldest)
+                oldest = mshr->entries[i].ready;
+        }
+
+        mshr->full_stalls++;
+        mshr->stall_cycles += oldest - mshr->now;
+        mshr->now = oldest;
+        mshr_retire(mshr);
+    }
+
+    mshr->entries[mshr->in_use].block = block;
+    mshr->entries[mshr->in_use].ready = mshr->now + mshr->latency;
+    mshr->in_use++;
+    mshr->allocations++;
+    if (mshr->in_use > mshr->peak)
+        mshr->peak = mshr->in_use;
+}
+
+/* Main-cache access that hands evictions to the victim cache. Returns true on a main hit. */
+static bool victim_access(cache_t *cache, uint32_t addr, bool is_write, bool *from_victim) {
+    victim_cache *victim = cache->victim;
+    uint32_t evicted, vc_evicted;
+    bool dirty = is_write, evicted_dirty, vc_evicted_dirty;
+
+    *from_victim = false;
+    if (cache_lookup(cache, addr, is_write)) {
+        if (is_write)
+            cache->stats.write_hits++;
+        else
+            cache->stats.read_hits++;
+        return true;
+    }
+
+    if (is_write)
+        cache->stats.write_misses++;
+    else
+        cache->stats.read_misses++;
+
+    if (cache_invalidate(victim->cache, addr, &evicted_dirty)) {
+        victim->hits++;
+        dirty |= evicted_dirty;
+        *from_victim = true;
+    } else {
+        victim->misses++;
+    }
+
+    if (!cache_insert(cache, addr, dirty, &evicted, &evicted_dirty))
+        return false;
+
+    if (evicted_dirty)
+        cache->stats.write_backs++;
+    if (cache_insert(victim->cache, evicted, evicted_dirty, &vc_evicted, &vc_evicted_dirty) && vc_evicted_dirty)
+        victim->write_backs++;
+
+    return false;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : miss_access                                     */
+/*                                                             */
+/* Purpose   : Simulate one access on a cache with a victim    */
+/*             cache and/or MSHRs. Returns true on a hit in    */
+/*             the main cache.                                 */
+/*                                                             */
+/***************************************************************/
+bool miss_access(cache_t *cache, const trace_record *record) {
+    mshr_file *mshr = cache->mshr;
+    uint32_t block = record->addr / cache->block_size;
+    bool from_victim = false;
+    bool is_hit;
+
+    if (cache->victim)
+        is_hit = victim_access(cache, record->addr, !record->is_read, &from_victim);
+    else
+        is_hit = cache_access(cache, record->addr, record->is_read);
+
+    if (mshr == NULL)
+        return is_hit;
+
+    mshr->now++;
+    mshr_retire(mshr);
+
+    /* A hit on a block whose fill is still in flight is a secondary miss */
+    if (is_hit) {
+        if (mshr->in_use && mshr_find(mshr, block) >= 0)
+            mshr->merges++;
+    } else if (!from_victim) {
+        mshr_miss(mshr, block);
+    }
+
+    return is_hit;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : miss_report                                     */
+/*                                                             */
+/* Purpose   : Dump victim cache and MSHR stat                 */
+/*                                                             */
+/***************************************************************/
+void miss_report(const cache_t *cache) {
+    const victim_cache *victim = cache->victim;
+    const mshr_file *mshr = cache->mshr;
+
+    if (victim) {
+        printf("Victim Cache Stat:\n");
+        printf("-------------------------------------\n");
+        printf("Entries: %d\n", victim->cache->assoc);
+        printf("Victim hits: %" PRIu64 "\n", victim->hits);
+        printf("Victim misses: %" PRIu64 "\n", victim->misses);
+        printf("Write-backs: %" PRIu64 "\n", victim->write_backs);
+        printf("\n");
+    }
+
+    if (mshr) {
+        printf("MSHR Stat:\n");
+        printf("-------------------------------------\n");
+        printf("Entries: %d (latency %d)\n", mshr->num_entries, mshr->latency);
+        printf("Allocations: %" PRIu64 "\n", mshr->allocations);
+        printf("Merged misses: %" PRIu64 "\n", mshr->merges);
+        printf("Full stalls: %" PRIu64 " (%" PRIu64 " cycles)\n", mshr->full_stalls, mshr->stall_cycles);
+        printf("Peak occupancy: %d\n", mshr->peak);
+        printf("\n");
+    }
+}
@@ -0,0 +1,66 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   miss.h                                                    */
+/*                                                             */
+/*   Structures behind a cache that handle its misses: a       */
+/*   fully-associative victim cache and miss-status holding    */
+/*   registers (MSHRs).                                        */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _MISS_H_
+#define _MISS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "trace.h"
+
+#define DEFAULT_MSHR_LATENCY	100
+
+struct cache_s;
+
+/* Holds blocks evicted from the main cache, LRU */
+typedef struct victim_cache {
+    struct cache_s *cache;	/* one set of num_entries ways */
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t write_backs;	/* dirty blocks leaving for memory */
+} victim_cache;
+
+typedef struct mshr_entry {
+    uint32_t block;
+    uint64_t ready;		/* time the fill arrives */
+} mshr_entry;
+
+/*
+ * Time advances by one per access. A miss that goes to memory holds an
+ * entry for latency accesses; later accesses to that block merge into it,
+ * and a miss that finds every entry busy stalls until the oldest retires.
+ */
+typedef struct mshr_file {
+    int num_entries;
+    int latency;
+    mshr_entry *entries;
+    int in_use;
+    uint64_t now;
+
+    uint64_t allocations;
+    uint64_t merges;
+    uint64_t full_stalls;
+    uint64_t stall_cycles;
+    int peak;
+} mshr_file;
+
+/* Functions */
+bool		parse_mshr_args(char *mshr_args, int *num_entries, int *latency);
+victim_cache*	victim_create(const struct cache_s *cache, int num_entries);
+void		victim_free(victim_cache *victim);
+mshr_file*	mshr_create(int num_entries, int latency);
+void		mshr_free(mshr_file *mshr);
+bool		miss_access(struct cache_s *cache, const trace_record *record);
+void		miss_report(const struct cache_s *cache);
+
+#endif
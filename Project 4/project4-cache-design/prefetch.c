@@ -0,0 +1,292 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   prefetch.c                                                */
+/*                                                             */
+/*   Each prefetcher observes the demand stream after the      */
+/*   cache has handled an access and names blocks to fetch.    */
+/*   Missing blocks are inserted clean through the normal      */
+/*   victim selection and tagged until their first demand hit, */
+/*   which is what accuracy, coverage and pollution are        */
+/*   measured from.                                            */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "cache.h"
+#include "prefetch.h"
+
+static const char *prefetch_names[NUM_PREFETCHERS] = { "none", "next", "stride", "stream", "ghb" };
+
+/* PCs and block numbers often differ only in high bits, so fold those down */
+static uint32_t hash_block(uint32_t block, uint32_t table_size) {
+    uint32_t h = block * 0x9e3779b1u;
+
+    return (h ^ (h >> 16)) & (table_size - 1);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_prefetch_args                             */
+/*                                                             */
+/* Purpose   : Parse name[:degree], e.g. stride:4              */
+/*                                                             */
+/***************************************************************/
+bool parse_prefetch_args(char *prefetch_args, int *kind, int *degree) {
+    char *colon = strchr(prefetch_args, ':');
+
+    *degree = 1;
+    if (colon) {
+        *colon = '\0';
+        *degree = strtol(colon + 1, NULL, 10);
+    }
+
+    for (int i = 0; i < NUM_PREFETCHERS; i++) {
+        if (strcmp(prefetch_args, prefetch_names[i]) == 0) {
+            *kind = i;
+            return *degree >= 1 && *degree <= PF_MAX_DEGREE;
+        }
+    }
+
+    return false;
+}
+
+prefetch_t *prefetch_create(const cache_t *cache, int kind, int degree) {
+    prefetch_t *prefetch = (prefetch_t *) calloc(1, sizeof(prefetch_t));
+    uint32_t blocks = (uint32_t) cache->num_sets * cache->assoc;
+
+    prefetch->kind = kind;
+    prefetch->degree = degree;
+    prefetch->prefetched = (uint64_t *) calloc((size_t) cache->num_sets * cache->mask_words, sizeof(uint64_t));
+
+    /* Remember about as many prefetch victims as the cache holds blocks */
+    prefetch->evicted_size = 1;
+    while (prefetch->evicted_size < blocks)
+        prefetch->evicted_size *= 2;
+    prefetch->evicted = (uint32_t *) calloc(prefetch->evicted_size, sizeof(uint32_t));
+
+    if (kind == PF_STRIDE)
+        prefetch->stride_table = (stride_entry *) calloc(PF_STRIDE_ENTRIES, sizeof(stride_entry));
+    if (kind == PF_GHB) {
+        prefetch->ghb = (uint32_t *) calloc(PF_GHB_ENTRIES, sizeof(uint32_t));
+        prefetch->ghb_index = (ghb_index_entry *) calloc(PF_GHB_INDEX_ENTRIES, sizeof(ghb_index_entry));
+    }
+
+    return prefetch;
+}
+
+void prefetch_free(prefetch_t *prefetch) {
+    if (prefetch == NULL)
+        return;
+
+    free(prefetch->prefetched);
+    free(prefetch->evicted);
+    free(prefetch->stride_table);
+    free(prefetch->ghb);
+    free(prefetch->ghb_index);
+    free(prefetch);
+}
+
+/* Fill one block unless it is already cached */
+static void issue(cache_t *cache, uint32_t block) {
+    prefetch_t *prefetch = cache->prefetch;
+    uint32_t set_index = cache_set(cache, block);
+    uint64_t *bits = prefetch->prefetched + (size_t) set_index * cache->mask_words;
+    uint32_t victim;
+    bool victim_dirty;
+    int way;
+
+    if (block > UINT32_MAX / cache->block_size || find_way(cache, set_index, cache_tag(cache, block)) >= 0)
+        return;
+
+    if (cache_insert(cache, block * cache->block_size, false, &victim, &victim_dirty)) {
+        uint32_t victim_block = victim / cache->block_size;
+
+        if (victim_dirty)
+            cache->stats.write_backs++;
+        prefetch->evicted[hash_block(victim_block, prefetch->evicted_size)] = victim_block + 1;
+    }
+
+    way = find_way(cache, set_index, cache_tag(cache, block));
+    if (TEST_WAY(bits, way))
+        prefetch->stats.useless++;
+    bits[way >> 6] |= WAY_BIT(way);
+    prefetch->stats.issued++;
+}
+
+static void next_line(cache_t *cache, uint32_t block) {
+    for (int i = 1; i <= cache->prefetch->degree; i++)
+        issue(cache, block + i);
+}
+
+/* Reference prediction table: prefetch once a PC repeats the same stride */
+static void stride(cache_t *cache, const trace_record *record) {
+    prefetch_t *prefetch = cache->prefetch;
+    stride_entry *entry = &prefetch->stride_table[hash_block(record->pc, PF_STRIDE_ENTRIES)];
+    int32_t delta;
+
+    if (!entry->valid || entry->pc != record->pc) {
+        entry->valid = true;
+        entry->pc = record->pc;
+        entry->last_addr = record->addr;
+        entry->stride = 0;
+        entry->confidence = 0;
+        return;
+    }
+
+    delta = (int32_t) (record->addr - entry->last_addr);
+    entry->last_addr = record->addr;
+    if (delta == entry->stride) {
+        if (entry->confidence < 3)
+            entry->confidence++;
+    } else if (entry->confidence > 0) {
+        entry->confidence--;
+    } else {
+        entry->stride = delta;
+    }
+
+    if (entry->confidence < 2 || entry->stride == 0)
+        return;
+
+    for (int i = 1; i <= prefetch->degree; i++) {
+        uint32_t target = record->addr + (uint32_t) entry->stride * i;
+
+        issue(cache, target / cache->block_size);
+    }
+}
+
+/* Ascending streams: a trigger at a tracker's expected block runs it degree blocks ahead */
+static void stream(cache_t *cache, uint32_t block) {
+    prefetch_t *prefetch = cache->prefetch;
+    stream_tracker *tracker = NULL;
+    stream_tracker *oldest = &prefetch->trackers[0];
+
+    prefetch->now++;
+    for (int i = 0; i < PF_STREAM_TRACKERS; i++) {
+        stream_tracker *t = &prefetch->trackers[i];
+
+        if (t->valid && block >= t->next_block - 1 && block < t->next_block + prefetch->degree)
+            tracker = t;
+        if (!t->valid || t->last_use < oldest->last_use)
+            oldest = t;
+    }
+
+    if (tracker == NULL) {
+        /* Allocate on a miss; the stream is confirmed by the next block */
+        oldest->valid = true;
+        oldest->next_block = block + 1;
+        oldest->last_use = prefetch->now;
+        return;
+    }
+
+    tracker->last_use = prefetch->now;
+    if (block + 1 > tracker->next_block)
+        tracker->next_block = block + 1;
+    for (int i = 0; i < prefetch->degree; i++)
+        issue(cache, tracker->next_block + i);
+}
+
+/* Global history of trigger blocks: prefetch what followed the last occurrence of this one */
+static void ghb(cache_t *cache, uint32_t block) {
+    prefetch_t *prefetch = cache->prefetch;
+    ghb_index_entry *index = &prefetch->ghb_index[hash_block(block, PF_GHB_INDEX_ENTRIES)];
+
+    if (index->valid && index->block == block && prefetch->ghb_pos - index->pos < PF_GHB_ENTRIES) {
+        for (uint64_t p = index->pos + 1; p < prefetch->ghb_pos && p <= index->pos + prefetch->degree; p++)
+            issue(cache, prefetch->ghb[p % PF_GHB_ENTRIES]);
+    }
+
+    prefetch->ghb[prefetch->ghb_pos % PF_GHB_ENTRIES] = block;
+    index->valid = true;
+    index->block = block;
+    index->pos = prefetch->ghb_pos++;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : prefetch_access                                 */
+/*                                                             */
+/* Purpose   : Account a demand access that cache_access()     */
+/*             just handled and run the prefetcher on it       */
+/*                                                             */
+/***************************************************************/
+void prefetch_access(cache_t *cache, const trace_record *record, bool is_hit) {
+    prefetch_t *prefetch = cache->prefetch;
+    uint32_t block = record->addr / cache->block_size;
+    uint32_t set_index = cache_set(cache, block);
+    uint64_t *bits = prefetch->prefetched + (size_t) set_index * cache->mask_words;
+    int way = find_way(cache, set_index, cache_tag(cache, block));
+    bool trigger = !is_hit;
+
+    /*
+     * On a miss the tag belongs to whatever block the demand fill replaced.
+     * A write miss under a no-allocate policy fills nothing, so no way is found.
+     */
+    if (way >= 0 && TEST_WAY(bits, way)) {
+        bits[way >> 6] &= ~WAY_BIT(way);
+        if (is_hit) {
+            prefetch->stats.useful++;
+            trigger = true;
+        } else {
+            prefetch->stats.useless++;
+        }
+    }
+
+    if (!is_hit) {
+        uint32_t *evicted = &prefetch->evicted[hash_block(block, prefetch->evicted_size)];
+
+        if (*evicted == block + 1) {
+            prefetch->stats.pollution++;
+            *evicted = 0;
+        }
+    }
+
+    switch (prefetch->kind) {
+        case PF_NEXT_LINE:
+            if (trigger)
+                next_line(cache, block);
+            break;
+        case PF_STRIDE:
+            stride(cache, record);
+            break;
+        case PF_STREAM:
+            if (trigger)
+                stream(cache, block);
+            break;
+        case PF_GHB:
+            if (trigger)
+                ghb(cache, block);
+            break;
+    }
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : prefetch_report                                 */
+/*                                                             */
+/* Purpose   : Dump prefetch stat. Coverage is the share of    */
+/*             would-be misses that prefetched blocks served.  */
+/*                                                             */
+/***************************************************************/
+void prefetch_report(const cache_t *cache) {
+    const prefetch_stats *stats = &cache->prefetch->stats;
+    uint64_t misses = cache->stats.read_misses + cache->stats.write_misses;
+
+    printf("Prefetch Stat:\n");
+    printf("-------------------------------------\n");
+    printf("Prefetcher: %s (degree %d)\n", prefetch_names[cache->prefetch->kind], cache->prefetch->degree);
+    printf("Prefetches issued: %" PRIu64 "\n", stats->issued);
+    printf("Useful prefetches: %" PRIu64 "\n", stats->useful);
+    printf("Useless prefetches: %" PRIu64 "\n", stats->useless);
+    printf("Pollution misses: %" PRIu64 "\n", stats->pollution);
+    printf("Accuracy: %.2f%%\n", stats->issued ? 100.0 * stats->useful / stats->issued : 0.0);
+    printf("Coverage: %.2f%%\n", stats->useful + misses ? 100.0 * stats->useful / (stats->useful + misses) : 0.0);
+    printf("\n");
+}
@@ -0,0 +1,86 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   prefetch.h                                                */
+/*                                                             */
+/*   Hardware prefetchers that fill into a cache's own sets.   */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _PREFETCH_H_
+#define _PREFETCH_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "trace.h"
+
+#define PF_NONE			0
+#define PF_NEXT_LINE		1	/* next N blocks, on a miss or first use of a prefetched block */
+#define PF_STRIDE		2	/* per-PC reference prediction table */
+#define PF_STREAM		3	/* sequential stream trackers */
+#define PF_GHB			4	/* global history buffer, address correlation */
+#define NUM_PREFETCHERS		5
+
+#define PF_MAX_DEGREE		16
+#define PF_STRIDE_ENTRIES	256
+#define PF_STREAM_TRACKERS	8
+#define PF_GHB_ENTRIES		1024
+#define PF_GHB_INDEX_ENTRIES	4096
+
+struct cache_s;
+
+typedef struct prefetch_stats {
+    uint64_t issued;		/* blocks filled by the prefetcher */
+    uint64_t useful;		/* prefetched blocks later hit by a demand access */
+    uint64_t useless;		/* prefetched blocks evicted before any use */
+    uint64_t pollution;		/* demand misses to blocks a prefetch had evicted */
+} prefetch_stats;
+
+typedef struct stride_entry {
+    bool valid;
+    uint32_t pc;
+    uint32_t last_addr;
+    int32_t stride;
+    uint8_t confidence;		/* 2-bit, predicts from 2 */
+} stride_entry;
+
+typedef struct stream_tracker {
+    bool valid;
+    uint32_t next_block;	/* block expected to miss next */
+    uint64_t last_use;
+} stream_tracker;
+
+typedef struct ghb_index_entry {
+    bool valid;
+    uint32_t block;
+    uint64_t pos;		/* latest position of block in the history */
+} ghb_index_entry;
+
+typedef struct prefetch_s {
+    int kind;
+    int degree;
+
+    uint64_t *prefetched;	/* one bit per way, mask_words per set, set until first use */
+    uint32_t *evicted;		/* block + 1 of recent prefetch victims, direct-mapped */
+    uint32_t evicted_size;
+
+    stride_entry *stride_table;
+    stream_tracker trackers[PF_STREAM_TRACKERS];
+    uint64_t now;
+    uint32_t *ghb;
+    ghb_index_entry *ghb_index;
+    uint64_t ghb_pos;
+
+    prefetch_stats stats;
+} prefetch_t;
+
+/* Functions */
+bool		parse_prefetch_args(char *prefetch_args, int *kind, int *degree);
+prefetch_t*	prefetch_create(const struct cache_s *cache, int kind, int degree);
+void		prefetch_access(struct cache_s *cache, const trace_record *record, bool is_hit);
+void		prefetch_report(const struct cache_s *cache);
+void		prefetch_free(prefetch_t *prefetch);
+
+#endif
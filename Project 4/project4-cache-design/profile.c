@@ -0,0 +1,292 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   profile.c                                                 */
+/*                                                             */
+/*   Sets are counted in a flat array. Regions are only known  */
+/*   as the trace touches them, so they live in a hash table   */
+/*   with linear probing that doubles when half full.          */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "cache.h"
+#include "profile.h"
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_profile_args                              */
+/*                                                             */
+/* Purpose   : Parse top[:region_size], e.g. 20:65536          */
+/*                                                             */
+/***************************************************************/
+bool parse_profile_args(char *profile_args, int *top, int *region_size) {
+    char *colon = strchr(profile_args, ':');
+
+    *region_size = DEFAULT_PROFILE_REGION;
+    if (colon)
+        *region_size = strtol(colon + 1, NULL, 10);
+    *top = strtol(profile_args, NULL, 10);
+
+    return *top >= 0 && *region_size >= 1;
+}
+
+profile_t *profile_create(const cache_t *cache, int top, int region_size) {
+    profile_t *profile = (profile_t *) calloc(1, sizeof(profile_t));
+
+    profile->top = top;
+    profile->region_size = region_size;
+    profile->sets = (profile_counts *) calloc(cache->num_sets, sizeof(profile_counts));
+    profile->region_slots = 1024;
+    profile->regions = (profile_region *) calloc(profile->region_slots, sizeof(profile_region));
+
+    return profile;
+}
+
+void profile_free(profile_t *profile) {
+    if (profile == NULL)
+        return;
+
+    free(profile->sets);
+    free(profile->regions);
+    free(profile);
+}
+
+static uint32_t hash_region(uint32_t region) {
+    uint32_t h = region * 0x9E3779B1u;
+
+    return h ^ (h >> 15);
+}
+
+static profile_region *find_slot(profile_region *slots, uint32_t num_slots, uint32_t region) {
+    uint32_t i = hash_region(region) & (num_slots - 1);
+
+    while (slots[i].used && slots[i].region != region)
+        i = (i + 1) & (num_slots - 1);
+
+    return &slots[i];
+}
+
+static void grow_regions(profile_t *profile) {
+    uint32_t old_slots = profile->region_slots;
+    profile_region *old = profile->regions;
+
+    profile->region_slots = old_slots * 2;
+    profile->regions = (profile_region *) calloc(profile->region_slots, sizeof(profile_region));
+    for (uint32_t i = 0; i < old_slots; i++) {
+        if (old[i].used)
+            *find_slot(profile->regions, profile->region_slots, old[i].region) = old[i];
+    }
+    free(old);
+}
+
+static profile_counts *region_counts(profile_t *profile, uint32_t addr) {
+    uint32_t region = addr / profile->region_size;
+    profile_region *slot = find_slot(profile->regions, profile->region_slots, region);
+
+    if (!slot->used) {
+        if (2 * (profile->num_regions + 1) > profile->region_slots) {
+            grow_regions(profile);
+            slot = find_slot(profile->regions, profile->region_slots, region);
+        }
+        slot->used = true;
+        slot->region = region;
+        profile->num_regions++;
+    }
+
+    return &slot->counts;
+}
+
+void profile_access(profile_t *profile, uint32_t set_index, uint32_t addr, bool is_hit) {
+    profile_counts *region = region_counts(profile, addr);
+
+    if (is_hit) {
+        profile->sets[set_index].hits++;
+        region->hits++;
+    } else {
+        profile->sets[set_index].misses++;
+        region->misses++;
+    }
+}
+
+void profile_evict(profile_t *profile, uint32_t set_index, uint32_t victim_addr, bool dirty) {
+    profile_counts *region = region_counts(profile, victim_addr);
+
+    profile->sets[set_index].evictions++;
+    region->evictions++;
+    if (dirty) {
+        profile->sets[set_index].write_backs++;
+        region->write_backs++;
+    }
+}
+
+/* Most misses first, then most evictions, then lowest index */
+static int compare_hottest(const void *a, const void *b) {
+    const profile_region *x = (const profile_region *) a;
+    const profile_region *y = (const profile_region *) b;
+
+    if (x->counts.misses != y->counts.misses)
+        return x->counts.misses > y->counts.misses ? -1 : 1;
+    if (x->counts.evictions != y->counts.evictions)
+        return x->counts.evictions > y->counts.evictions ? -1 : 1;
+    return (x->region > y->region) - (x->region < y->region);
+}
+
+/* Every set as a region list, so sets and regions sort and print alike */
+static profile_region *collect_sets(const cache_t *cache, uint32_t *count) {
+    const profile_t *profile = cache->profile;
+    profile_region *list = (profile_region *) malloc(sizeof(profile_region) * cache->num_sets);
+    uint32_t n = 0;
+
+    for (int i = 0; i < cache->num_sets; i++) {
+        list[n].region = i;
+        list[n].used = true;
+        list[n].counts = profile->sets[i];
+        n++;
+    }
+
+    *count = n;
+    return list;
+}
+
+static profile_region *collect_regions(const profile_t *profile, uint32_t *count) {
+    profile_region *list = (profile_region *) malloc(sizeof(profile_region) * (profile->num_regions + 1));
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < profile->region_slots; i++) {
+        if (profile->regions[i].used)
+            list[n++] = profile->regions[i];
+    }
+
+    *count = n;
+    return list;
+}
+
+static void print_counts(const profile_counts *counts) {
+    printf("hits %" PRIu64 ", misses %" PRIu64 ", evictions %" PRIu64 ", write-backs %" PRIu64 "\n",
+           counts->hits, counts->misses, counts->evictions, counts->write_backs);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : profile_report                                  */
+/*                                                             */
+/* Purpose   : Dump the top-N sets and regions by misses       */
+/*                                                             */
+/***************************************************************/
+void profile_report(const cache_t *cache) {
+    const profile_t *profile = cache->profile;
+    profile_region *sets, *regions;
+    uint32_t num_sets, num_regions;
+
+    sets = collect_sets(cache, &num_sets);
+    regions = collect_regions(profile, &num_regions);
+    qsort(sets, num_sets, sizeof(profile_region), compare_hottest);
+    qsort(regions, num_regions, sizeof(profile_region), compare_hottest);
+
+    printf("Profile Stat:\n");
+    printf("-------------------------------------\n");
+    printf("Regions touched: %" PRIu32 " (%" PRIu32 "B each)\n", num_regions, profile->region_size);
+    printf("Hottest sets:\n");
+    for (uint32_t i = 0; i < num_sets && i < (uint32_t) profile->top; i++) {
+        printf("SET[%" PRIu32 "]: ", sets[i].region);
+        print_counts(&sets[i].counts);
+    }
+    printf("Hottest regions:\n");
+    for (uint32_t i = 0; i < num_regions && i < (uint32_t) profile->top; i++) {
+        printf("0x%08" PRIx32 ": ", (uint32_t) ((uint64_t) regions[i].region * profile->region_size));
+        print_counts(&regions[i].counts);
+    }
+    printf("\n");
+
+    free(sets);
+    free(regions);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : profile_export                                  */
+/*                                                             */
+/* Purpose   : Write every set and touched region of one       */
+/*             configuration as CSV rows or as one JSON object */
+/*             of a top-level array. Regions are in address    */
+/*             order.                                          */
+/*                                                             */
+/***************************************************************/
+void profile_export_header(FILE *fp, bool json) {
+    if (json)
+        fprintf(fp, "[\n");
+    else
+        fprintf(fp, "capacity,associativity,block_size,policy,kind,index,address,hits,misses,evictions,write_backs\n");
+}
+
+static int compare_region(const void *a, const void *b) {
+    uint32_t x = ((const profile_region *) a)->region;
+    uint32_t y = ((const profile_region *) b)->region;
+
+    return (x > y) - (x < y);
+}
+
+static void export_list(FILE *fp, const cache_t *cache, const char *kind, const profile_region *list,
+                        uint32_t count, uint32_t unit, bool json) {
+    for (uint32_t i = 0; i < count; i++) {
+        const profile_counts *c = &list[i].counts;
+        char addr[16] = "";
+
+        /* Sets have no address of their own */
+        if (unit)
+            snprintf(addr, sizeof(addr), "0x%08" PRIx32, (uint32_t) ((uint64_t) list[i].region * unit));
+
+        if (json)
+            fprintf(fp, "      {\"index\": %" PRIu32 "%s%s%s, \"hits\": %" PRIu64 ", \"misses\": %" PRIu64
+                    ", \"evictions\": %" PRIu64 ", \"write_backs\": %" PRIu64 "}%s\n",
+                    list[i].region, unit ? ", \"address\": \"" : "", addr, unit ? "\"" : "",
+                    c->hits, c->misses, c->evictions, c->write_backs, (i + 1 < count) ? "," : "");
+        else
+            fprintf(fp, "%d,%d,%d,%s,%s,%" PRIu32 ",%s,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+                    cache->capacity, cache->assoc, cache->block_size, cache->policy->name, kind,
+                    list[i].region, addr, c->hits, c->misses, c->evictions, c->write_backs);
+    }
+}
+
+void profile_export(FILE *fp, const cache_t *cache, bool json, bool first) {
+    const profile_t *profile = cache->profile;
+    profile_region *sets, *regions;
+    uint32_t num_sets, num_regions;
+
+    sets = collect_sets(cache, &num_sets);
+    regions = collect_regions(profile, &num_regions);
+    qsort(regions, num_regions, sizeof(profile_region), compare_region);
+
+    if (json) {
+        fprintf(fp, "%s  {\n", first ? "" : ",\n");
+        fprintf(fp, "    \"capacity\": %d, \"associativity\": %d, \"block_size\": %d, \"policy\": \"%s\",\n",
+                cache->capacity, cache->assoc, cache->block_size, cache->policy->name);
+        fprintf(fp, "    \"region_size\": %" PRIu32 ",\n", profile->region_size);
+        fprintf(fp, "    \"sets\": [\n");
+        export_list(fp, cache, "set", sets, num_sets, 0, json);
+        fprintf(fp, "    ],\n");
+        fprintf(fp, "    \"regions\": [\n");
+        export_list(fp, cache, "region", regions, num_regions, profile->region_size, json);
+        fprintf(fp, "    ]\n");
+        fprintf(fp, "  }");
+    } else {
+        export_list(fp, cache, "set", sets, num_sets, 0, json);
+        export_list(fp, cache, "region", regions, num_regions, profile->region_size, json);
+    }
+
+    free(sets);
+    free(regions);
+}
+
+void profile_export_footer(FILE *fp, bool json) {
+    if (json)
+        fprintf(fp, "\n]\n");
+}
@@ -0,0 +1,66 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   profile.h                                                 */
+/*                                                             */
+/*   Per-set and per-address-region access profile: hits,     */
+/*   misses, evictions and write-backs, exported as CSV or    */
+/*   JSON and summarized as the hottest sets and regions.      */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define DEFAULT_PROFILE_TOP	10
+#define DEFAULT_PROFILE_REGION	4096
+
+struct cache_s;
+
+typedef struct profile_counts {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t write_backs;
+} profile_counts;
+
+/* One address region in the open-addressing region table */
+typedef struct profile_region {
+    uint32_t region;		/* address / region_size */
+    bool used;
+    profile_counts counts;
+} profile_region;
+
+/*
+ * Hits and misses are charged to the set and region being accessed.
+ * Evictions and write-backs are charged to the set and to the region of
+ * the block that leaves, so a region's evictions say how often its data
+ * was pushed out.
+ */
+typedef struct profile_s {
+    int top;			/* sets and regions in the summary, 0 for none */
+    uint32_t region_size;
+    profile_counts *sets;	/* num_sets entries */
+
+    profile_region *regions;
+    uint32_t num_regions;
+    uint32_t region_slots;	/* power of two */
+} profile_t;
+
+/* Functions */
+bool		parse_profile_args(char *profile_args, int *top, int *region_size);
+profile_t*	profile_create(const struct cache_s *cache, int top, int region_size);
+void		profile_free(profile_t *profile);
+void		profile_access(profile_t *profile, uint32_t set_index, uint32_t addr, bool is_hit);
+void		profile_evict(profile_t *profile, uint32_t set_index, uint32_t victim_addr, bool dirty);
+void		profile_report(const struct cache_s *cache);
+void		profile_export_header(FILE *fp, bool json);
+void		profile_export(FILE *fp, const struct cache_s *cache, bool json, bool first);
+void		profile_export_footer(FILE *fp, bool json);
+
+#endif
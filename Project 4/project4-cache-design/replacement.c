@@ -0,0 +1,249 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   replacement.c                                             */
+/*                                                             */
+/*   Replacement policies and their per-set metadata:          */
+/*                                                             */
+/*     lru     : 16-bit recency rank per way                   */
+/*     plru    : tree pseudo-LRU, assoc - 1 node bits          */
+/*     bitplru : one MRU bit per way                           */
+/*     srrip   : 2-bit re-reference prediction value per way   */
+/*     brrip   : as srrip, inserting at distant RRPV mostly    */
+/*     fifo    : 16-bit round-robin insertion pointer          */
+/*     random  : no metadata, seeded per configuration         */
+/*                                                             */
+/***************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "replacement.h"
+
+#define RRPV_MAX		3
+#define RRPV_LONG		(RRPV_MAX - 1)
+#define BRRIP_LONG_CHANCE	32	/* 1 in 32 BRRIP fills insert at RRPV_LONG */
+
+#define GET_BIT(META, I)	(((META)[(I) >> 3] >> ((I) & 7)) & 1)
+#define SET_BIT(META, I)	((META)[(I) >> 3] |= (uint8_t) (1 << ((I) & 7)))
+#define CLEAR_BIT(META, I)	((META)[(I) >> 3] &= (uint8_t) ~(1 << ((I) & 7)))
+
+#define GET_RRPV(META, I)	(((META)[(I) >> 2] >> (((I) & 3) * 2)) & 3)
+#define SET_RRPV(META, I, V)	((META)[(I) >> 2] = (uint8_t) (((META)[(I) >> 2] & ~(3 << (((I) & 3) * 2))) \
+				 | ((V) << (((I) & 3) * 2))))
+
+/* xorshift64* */
+uint64_t repl_random(uint64_t *rng) {
+    uint64_t x = *rng;
+
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *rng = x;
+    return x * 0x2545f4914f6cdd1dull;
+}
+
+static size_t no_meta_size(int assoc) {
+    (void) assoc;
+    return 0;
+}
+
+static size_t bit_meta_size(int assoc) {
+    return (assoc + 7) / 8;
+}
+
+static size_t rrpv_meta_size(int assoc) {
+    return (assoc + 3) / 4;
+}
+
+static size_t lru_meta_size(int assoc) {
+    return sizeof(uint16_t) * assoc;
+}
+
+static size_t fifo_meta_size(int assoc) {
+    (void) assoc;
+    return sizeof(uint16_t);
+}
+
+static void zero_init(uint8_t *meta, int assoc) {
+    (void) meta;
+    (void) assoc;
+}
+
+/* LRU: ranks are a permutation of 0 (MRU) .. assoc-1 (LRU) */
+static void lru_init(uint8_t *meta, int assoc) {
+    uint16_t *lru = (uint16_t *) meta;
+
+    for (int i = 0; i < assoc; i++)
+        lru[i] = i;
+}
+
+static void lru_touch(uint8_t *meta, int assoc, int way, bool is_fill, uint64_t *rng) {
+    uint16_t *lru = (uint16_t *) meta;
+    uint16_t rank = lru[way];
+    (void) is_fill;
+    (void) rng;
+
+    if (rank == 0)
+        return;
+
+    for (int i = 0; i < assoc; i++)
+        lru[i] += (lru[i] < rank);
+    lru[way] = 0;
+}
+
+static int lru_victim(uint8_t *meta, int assoc, uint64_t *rng) {
+    const uint16_t *lru = (const uint16_t *) meta;
+    (void) rng;
+
+    for (int i = 0; i < assoc; i++) {
+        if (lru[i] == assoc - 1)
+            return i;
+    }
+
+    return 0;
+}
+
+/* Tree-PLRU: node i (1-based heap order) points towards the less recent half */
+static void tree_plru_touch(uint8_t *meta, int assoc, int way, bool is_fill, uint64_t *rng) {
+    int node = 1;
+    (void) is_fill;
+    (void) rng;
+
+    for (int half = assoc >> 1; half > 0; half >>= 1) {
+        int right = (way & half) != 0;
+
+        if (right)
+            CLEAR_BIT(meta, node);
+        else
+            SET_BIT(meta, node);
+        node = node * 2 + right;
+    }
+}
+
+static int tree_plru_victim(uint8_t *meta, int assoc, uint64_t *rng) {
+    int node = 1;
+    (void) rng;
+
+    while (node < assoc)
+        node = node * 2 + GET_BIT(meta, node);
+
+    return node - assoc;
+}
+
+/* Bit-PLRU: set the way's MRU bit; once all are set, keep only this one */
+static void bit_plru_touch(uint8_t *meta, int assoc, int way, bool is_fill, uint64_t *rng) {
+    int i;
+    (void) is_fill;
+    (void) rng;
+
+    SET_BIT(meta, way);
+    for (i = 0; i < assoc; i++) {
+        if (!GET_BIT(meta, i))
+            return;
+    }
+
+    memset(meta, 0, bit_meta_size(assoc));
+    SET_BIT(meta, way);
+}
+
+static int bit_plru_victim(uint8_t *meta, int assoc, uint64_t *rng) {
+    (void) rng;
+
+    for (int i = 0; i < assoc; i++) {
+        if (!GET_BIT(meta, i))
+            return i;
+    }
+
+    return 0;
+}
+
+/* RRIP: hits predict near re-reference, fills a long (SRRIP) or mostly distant (BRRIP) one */
+static void rrip_hit(uint8_t *meta, int way) {
+    SET_RRPV(meta, way, 0);
+}
+
+static void srrip_touch(uint8_t *meta, int assoc, int way, bool is_fill, uint64_t *rng) {
+    (void) assoc;
+    (void) rng;
+
+    if (is_fill)
+        SET_RRPV(meta, way, RRPV_LONG);
+    else
+        rrip_hit(meta, way);
+}
+
+static void brrip_touch(uint8_t *meta, int assoc, int way, bool is_fill, uint64_t *rng) {
+    (void) assoc;
+
+    if (!is_fill)
+        rrip_hit(meta, way);
+    else if (repl_random(rng) % BRRIP_LONG_CHANCE == 0)
+        SET_RRPV(meta, way, RRPV_LONG);
+    else
+        SET_RRPV(meta, way, RRPV_MAX);
+}
+
+static int rrip_victim(uint8_t *meta, int assoc, uint64_t *rng) {
+    (void) rng;
+
+    for (;;) {
+        for (int i = 0; i < assoc; i++) {
+            if (GET_RRPV(meta, i) == RRPV_MAX)
+                return i;
+        }
+        for (int i = 0; i < assoc; i++)
+            SET_RRPV(meta, i, GET_RRPV(meta, i) + 1);
+    }
+}
+
+/* FIFO: evict in insertion order with a round-robin pointer */
+static void fifo_touch(uint8_t *meta, int assoc, int way, bool is_fill, uint64_t *rng) {
+    uint16_t *next = (uint16_t *) meta;
+    (void) rng;
+
+    if (is_fill && way == *next)
+        *next = (way + 1) % assoc;
+}
+
+static int fifo_victim(uint8_t *meta, int assoc, uint64_t *rng) {
+    (void) assoc;
+    (void) rng;
+
+    return *(uint16_t *) meta;
+}
+
+static void random_touch(uint8_t *meta, int assoc, int way, bool is_fill, uint64_t *rng) {
+    (void) meta;
+    (void) assoc;
+    (void) way;
+    (void) is_fill;
+    (void) rng;
+}
+
+static int random_victim(uint8_t *meta, int assoc, uint64_t *rng) {
+    (void) meta;
+
+    return repl_random(rng) % assoc;
+}
+
+const repl_policy repl_policies[NUM_REPL] = {
+    [REPL_LRU]       = { "lru",     false, false, lru_meta_size,  lru_init,  lru_touch,       lru_victim },
+    [REPL_TREE_PLRU] = { "plru",    true,  false, bit_meta_size,  zero_init, tree_plru_touch, tree_plru_victim },
+    [REPL_BIT_PLRU]  = { "bitplru", false, false, bit_meta_size,  zero_init, bit_plru_touch,  bit_plru_victim },
+    [REPL_SRRIP]     = { "srrip",   false, false, rrpv_meta_size, zero_init, srrip_touch,     rrip_victim },
+    [REPL_BRRIP]     = { "brrip",   false, true,  rrpv_meta_size, zero_init, brrip_touch,     rrip_victim },
+    [REPL_FIFO]      = { "fifo",    false, false, fifo_meta_size, zero_init, fifo_touch,      fifo_victim },
+    [REPL_RANDOM]    = { "random",  false, true,  no_meta_size,   zero_init, random_touch,    random_victim },
+};
+
+int find_repl_policy(const char *name) {
+    for (int i = 0; i < NUM_REPL; i++) {
+        if (strcmp(repl_policies[i].name, name) == 0)
+            return i;
+    }
+
+    return -1;
+}
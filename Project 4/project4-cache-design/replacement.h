@@ -0,0 +1,46 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   replacement.h                                             */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _REPLACEMENT_H_
+#define _REPLACEMENT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define REPL_LRU	0
+#define REPL_TREE_PLRU	1
+#define REPL_BIT_PLRU	2
+#define REPL_SRRIP	3
+#define REPL_BRRIP	4
+#define REPL_FIFO	5
+#define REPL_RANDOM	6
+#define NUM_REPL	7
+
+/*
+ * A replacement policy owns meta_size(assoc) bytes at the end of every
+ * set. touch() is called on every hit and on every fill; victim() is
+ * only asked once the set has no empty way left.
+ */
+typedef struct repl_policy {
+    const char *name;
+    bool needs_pow2_assoc;
+    bool uses_rng;		/* draws from the cache's generator, so sets are not independent */
+    size_t (*meta_size)(int assoc);
+    void (*init)(uint8_t *meta, int assoc);
+    void (*touch)(uint8_t *meta, int assoc, int way, bool is_fill, uint64_t *rng);
+    int (*victim)(uint8_t *meta, int assoc, uint64_t *rng);
+} repl_policy;
+
+extern const repl_policy repl_policies[NUM_REPL];
+
+/* Functions */
+int		find_repl_policy(const char *name);
+uint64_t	repl_random(uint64_t *rng);
+
+#endif
@@ -0,0 +1,261 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   sample.c                                                  */
+/*                                                             */
+/*   Read and write totals are counted over the whole trace,   */
+/*   so extrapolation only scales the hit and miss split. The  */
+/*   miss rate interval treats each unit as one cluster of a   */
+/*   ratio estimate.                                           */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "cache.h"
+#include "sample.h"
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_sample_args                               */
+/*                                                             */
+/* Purpose   : Parse set:ratio or                              */
+/*             time:measure:warmup:period, e.g. set:32 or      */
+/*             time:10000:20000:1000000                        */
+/*                                                             */
+/***************************************************************/
+bool parse_sample_args(char *sample_args, int *set_ratio, uint64_t *measure, uint64_t *warmup,
+                       uint64_t *period) {
+    char *saveptr;
+    char *kind = strtok_r(sample_args, ":", &saveptr);
+    char *token;
+
+    if (kind == NULL)
+        return false;
+
+    if (strcmp(kind, "set") == 0) {
+        token = strtok_r(NULL, ":", &saveptr);
+        if (token == NULL)
+            return false;
+        *set_ratio = strtol(token, NULL, 10);
+        return *set_ratio >= 1;
+    }
+
+    if (strcmp(kind, "time") == 0) {
+        uint64_t *fields[3] = { measure, warmup, period };
+
+        for (int i = 0; i < 3; i++) {
+            token = strtok_r(NULL, ":", &saveptr);
+            if (token == NULL)
+                return false;
+            *fields[i] = strtoull(token, NULL, 10);
+        }
+        return *measure >= 1 && *measure + *warmup <= *period;
+    }
+
+    return false;
+}
+
+static uint32_t hash_set(uint32_t set_index) {
+    uint32_t h = set_index * 0x9E3779B1u;
+
+    return h ^ (h >> 16);
+}
+
+sample_t *sample_create(const cache_t *cache, int set_ratio, uint64_t measure, uint64_t warmup,
+                        uint64_t period) {
+    sample_t *sample = (sample_t *) calloc(1, sizeof(sample_t));
+
+    sample->set_ratio = set_ratio > 1 ? set_ratio : 1;
+    sample->sampled_sets = cache->num_sets;
+    if (sample->set_ratio > 1) {
+        sample->sampled = (uint8_t *) calloc(cache->num_sets, 1);
+        sample->sampled_sets = 0;
+        for (int i = 0; i < cache->num_sets; i++) {
+            sample->sampled[i] = (hash_set(i) % sample->set_ratio == 0);
+            sample->sampled_sets += sample->sampled[i];
+        }
+        if (sample->sampled_sets == 0) {
+            sample->sampled[0] = 1;
+            sample->sampled_sets = 1;
+        }
+    }
+
+    sample->measure = measure;
+    sample->warmup = warmup;
+    sample->period = period;
+
+    /* Windows are added as they open; sets are all known up front */
+    if (period == 0) {
+        sample->num_units = sample->max_units = cache->num_sets;
+        sample->units = (sample_unit *) calloc(cache->num_sets, sizeof(sample_unit));
+    }
+
+    return sample;
+}
+
+void sample_free(sample_t *sample) {
+    if (sample == NULL)
+        return;
+
+    free(sample->sampled);
+    free(sample->units);
+    free(sample);
+}
+
+static void open_window(sample_t *sample) {
+    if (sample->num_units == sample->max_units) {
+        sample->max_units = sample->max_units ? sample->max_units * 2 : 64;
+        sample->units = (sample_unit *) realloc(sample->units, sample->max_units * sizeof(sample_unit));
+    }
+
+    memset(&sample->units[sample->num_units++], 0, sizeof(sample_unit));
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : sample_access                                   */
+/*                                                             */
+/* Purpose   : Simulate one record on a sampled configuration, */
+/*             or skip it if it falls outside the sample       */
+/*                                                             */
+/***************************************************************/
+void sample_access(cache_t *cache, const trace_record *record) {
+    sample_t *sample = cache->sample;
+    uint32_t set_index = cache_set(cache, record->addr / cache->block_size);
+    bool warming = false;
+    sample_unit *unit;
+
+    if (record->is_read)
+        sample->seen_reads++;
+    else
+        sample->seen_writes++;
+
+    if (sample->period) {
+        uint64_t p = sample->position++ % sample->period;
+        uint64_t start = sample->period - sample->measure;
+
+        if (p < start - sample->warmup)
+            return;
+        if (p == start)
+            open_window(sample);
+        warming = (p < start);
+    }
+
+    if (sample->sampled && !sample->sampled[set_index])
+        return;
+
+    if (warming) {
+        cache_stats saved = cache->stats;
+
+        cache_access(cache, record->addr, record->is_read);
+        cache->stats = saved;
+        return;
+    }
+
+    unit = &sample->units[sample->period ? sample->num_units - 1 : (int) set_index];
+    unit->accesses++;
+    if (!cache_access(cache, record->addr, record->is_read))
+        unit->misses++;
+    sample->measured++;
+}
+
+static uint64_t scale(uint64_t count, uint64_t measured, uint64_t total) {
+    if (measured == 0)
+        return 0;
+
+    return (uint64_t) ((double) count * total / measured + 0.5);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : sample_finish                                   */
+/*                                                             */
+/* Purpose   : Replace the measured stats of a configuration   */
+/*             with estimates for the whole trace              */
+/*                                                             */
+/***************************************************************/
+void sample_finish(cache_t *cache) {
+    const sample_t *sample = cache->sample;
+    cache_stats *stats = &cache->stats;
+    uint64_t reads = stats->read_hits + stats->read_misses;
+    uint64_t writes = stats->write_hits + stats->write_misses;
+    uint64_t seen = sample->seen_reads + sample->seen_writes;
+
+    stats->read_hits = scale(stats->read_hits, reads, sample->seen_reads);
+    stats->read_misses = sample->seen_reads - stats->read_hits;
+    stats->write_hits = scale(stats->write_hits, writes, sample->seen_writes);
+    stats->write_misses = sample->seen_writes - stats->write_hits;
+    stats->write_backs = scale(stats->write_backs, reads + writes, seen);
+    stats->write_throughs = scale(stats->write_throughs, reads + writes, seen);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : sample_report                                   */
+/*                                                             */
+/* Purpose   : Dump the sample size and the estimated miss     */
+/*             rate with its 95% confidence interval           */
+/*                                                             */
+/***************************************************************/
+void sample_report(const cache_t *cache) {
+    const sample_t *sample = cache->sample;
+    uint64_t seen = sample->seen_reads + sample->seen_writes;
+    double accesses = 0, misses = 0, rate = 0, sum_sq = 0;
+    double population;
+    int n = 0;
+
+    for (int i = 0; i < sample->num_units; i++) {
+        if (sample->period == 0 && sample->sampled && !sample->sampled[i])
+            continue;
+        accesses += sample->units[i].accesses;
+        misses += sample->units[i].misses;
+        n++;
+    }
+    if (accesses > 0)
+        rate = misses / accesses;
+
+    for (int i = 0; i < sample->num_units; i++) {
+        double d = sample->units[i].misses - rate * sample->units[i].accesses;
+
+        if (sample->period == 0 && sample->sampled && !sample->sampled[i])
+            continue;
+        sum_sq += d * d;
+    }
+
+    /*
+     * Windows are drawn from every measure-sized stretch of the trace, not
+     * one per period, or the correction would shrink as windows approach
+     * the period count.
+     */
+    if (sample->period)
+        population = (double) sample->position / sample->measure;
+    else
+        population = cache->num_sets;
+
+    printf("Sampling Stat:\n");
+    printf("-------------------------------------\n");
+    printf("Sets simulated: %d of %d\n", sample->sampled_sets, cache->num_sets);
+    if (sample->period)
+        printf("Windows: %d (measure %" PRIu64 ", warm-up %" PRIu64 ", period %" PRIu64 ")\n",
+               sample->num_units, sample->measure, sample->warmup, sample->period);
+    printf("Records measured: %" PRIu64 " of %" PRIu64 "\n", sample->measured, seen);
+
+    if (n >= 2 && accesses > 0) {
+        double mean = accesses / n;
+        double fpc = (population > n) ? 1.0 - n / population : 0.0;
+        double ci = 1.96 * sqrt(fpc * sum_sq / ((double) n * (n - 1) * mean * mean));
+
+        printf("Miss rate: %.4f +/- %.4f (95%% confidence)\n", rate, ci);
+    } else {
+        printf("Miss rate: %.4f (too few units for a confidence interval)\n", rate);
+    }
+    printf("\n");
+}
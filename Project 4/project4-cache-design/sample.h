@@ -0,0 +1,64 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   sample.h                                                  */
+/*                                                             */
+/*   Sampled simulation: only a hashed subset of sets and/or   */
+/*   periodic windows of the trace are simulated, and the      */
+/*   stats are extrapolated to the whole trace.                */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _SAMPLE_H_
+#define _SAMPLE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "trace.h"
+
+struct cache_s;
+
+/* Accesses and misses measured in one sampling unit (a set or a window) */
+typedef struct sample_unit {
+    uint64_t accesses;
+    uint64_t misses;
+} sample_unit;
+
+/*
+ * Every period records the trace is skipped, then warmup records update
+ * the cache without being counted, then measure records are counted.
+ * With set sampling alone the units are the sampled sets, otherwise they
+ * are the measurement windows.
+ */
+typedef struct sample_s {
+    int set_ratio;		/* 1 in set_ratio sets is simulated, 1 for all */
+    uint8_t *sampled;		/* per set, NULL when every set is simulated */
+    int sampled_sets;
+
+    uint64_t measure;
+    uint64_t warmup;
+    uint64_t period;		/* 0 without time sampling */
+    uint64_t position;
+
+    uint64_t seen_reads;
+    uint64_t seen_writes;
+    uint64_t measured;
+
+    sample_unit *units;
+    int num_units;
+    int max_units;
+} sample_t;
+
+/* Functions */
+bool		parse_sample_args(char *sample_args, int *set_ratio, uint64_t *measure, uint64_t *warmup,
+				  uint64_t *period);
+sample_t*	sample_create(const struct cache_s *cache, int set_ratio, uint64_t measure, uint64_t warmup,
+			      uint64_t period);
+void		sample_free(sample_t *sample);
+void		sample_access(struct cache_s *cache, const trace_record *record);
+void		sample_finish(struct cache_s *cache);
+void		sample_report(const struct cache_s *cache);
+
+#endif
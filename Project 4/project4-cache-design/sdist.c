@@ -0,0 +1,418 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   sdist.c                                                   */
+/*                                                             */
+/*   Fully-associative LRU: the stack distance of an access is */
+/*   the number of distinct blocks touched since the previous  */
+/*   access to the same block. It is computed in O(log n) by   */
+/*   marking each block's last-use time in a Fenwick tree and  */
+/*   counting the marks after it. An access hits in every      */
+/*   capacity larger than its distance.                        */
+/*                                                             */
+/*   Set-associative LRU: every set count keeps one LRU stack  */
+/*   per set, bounded at the associativity, so one pass gives  */
+/*   the in-set distance histogram of every capacity.          */
+/*                                                             */
+/*   For write-backs, a miss at capacity c evicts the block at */
+/*   depth c - 1, found by an order-statistic descent of the   */
+/*   tree; it is dirty there if written since it last left c.  */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "sdist.h"
+
+#define SDIST_INITIAL_TIME	(1u << 20)
+#define SDIST_INITIAL_BLOCKS	(1u << 16)
+#define SDIST_COLD_BUCKET	(SDIST_HISTOGRAM_BUCKETS - 1)
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_sdist_args                                */
+/*                                                             */
+/* Purpose   : Parse min-max:assoc:blocksize. An associativity */
+/*             of 0 or "fa" selects fully-associative caches.  */
+/*                                                             */
+/***************************************************************/
+bool parse_sdist_args(char *sdist_args, int *min_capacity, int *max_capacity, int *assoc, int *block_size) {
+    int sdist_arg_num = 0;
+    char *token, *dash;
+    token = strtok(sdist_args, ":");
+
+    while (token) {
+        switch (sdist_arg_num) {
+            case 0:
+                dash = strchr(token, '-');
+                *min_capacity = strtol(token, NULL, 10);
+                *max_capacity = dash ? strtol(dash + 1, NULL, 10) : *min_capacity;
+                break;
+            case 1:
+                *assoc = (strcmp(token, "fa") == 0) ? SDIST_FULLY_ASSOC : strtol(token, NULL, 10);
+                break;
+            case 2:
+                *block_size = strtol(token, NULL, 10);
+                break;
+        }
+
+        token = strtok(NULL, ":");
+        sdist_arg_num++;
+    }
+
+    return sdist_arg_num == 3;
+}
+
+static void fenwick_add(uint32_t *fenwick, uint32_t size, uint32_t pos, int32_t value) {
+    for (pos++; pos <= size; pos += pos & -pos)
+        fenwick[pos - 1] += value;
+}
+
+/* Number of marks in [0, pos) */
+static uint32_t fenwick_prefix(const uint32_t *fenwick, uint32_t pos) {
+    uint32_t sum = 0;
+
+    for (; pos > 0; pos -= pos & -pos)
+        sum += fenwick[pos - 1];
+
+    return sum;
+}
+
+/* Position of the k-th mark (1-based); the tree size is a power of two */
+static uint32_t fenwick_find(const uint32_t *fenwick, uint32_t size, uint32_t k) {
+    uint32_t pos = 0;
+
+    for (uint32_t step = size; step > 0; step >>= 1) {
+        if (pos + step <= size && fenwick[pos + step - 1] < k) {
+            pos += step;
+            k -= fenwick[pos - 1];
+        }
+    }
+
+    return pos;
+}
+
+static uint32_t hash_block(uint32_t block, uint32_t table_size) {
+    return (block * 0x9e3779b1u) & (table_size - 1);
+}
+
+static void grow_block_table(sdist_t *sdist) {
+    sdist_block *old = sdist->blocks;
+    uint32_t old_size = sdist->block_table_size;
+
+    sdist->block_table_size *= 2;
+    sdist->blocks = (sdist_block *) calloc(sdist->block_table_size, sizeof(sdist_block));
+
+    for (uint32_t i = 0; i < old_size; i++) {
+        if (!old[i].used)
+            continue;
+
+        uint32_t h = hash_block(old[i].block, sdist->block_table_size);
+        while (sdist->blocks[h].used)
+            h = (h + 1) & (sdist->block_table_size - 1);
+        sdist->blocks[h] = old[i];
+    }
+
+    free(old);
+}
+
+static sdist_block *find_block(sdist_t *sdist, uint32_t block) {
+    uint32_t h = hash_block(block, sdist->block_table_size);
+
+    while (sdist->blocks[h].block != block || !sdist->blocks[h].used)
+        h = (h + 1) & (sdist->block_table_size - 1);
+
+    return &sdist->blocks[h];
+}
+
+static sdist_block *lookup_block(sdist_t *sdist, uint32_t block, bool *is_new) {
+    uint32_t h;
+
+    if (sdist->num_blocks * 2 >= sdist->block_table_size)
+        grow_block_table(sdist);
+
+    h = hash_block(block, sdist->block_table_size);
+    while (sdist->blocks[h].used) {
+        if (sdist->blocks[h].block == block) {
+            *is_new = false;
+            return &sdist->blocks[h];
+        }
+        h = (h + 1) & (sdist->block_table_size - 1);
+    }
+
+    sdist->blocks[h].used = true;
+    sdist->blocks[h].block = block;
+    sdist->num_blocks++;
+    *is_new = true;
+    return &sdist->blocks[h];
+}
+
+static int compare_last_time(const void *a, const void *b) {
+    uint32_t ta = (*(sdist_block * const *) a)->last_time;
+    uint32_t tb = (*(sdist_block * const *) b)->last_time;
+
+    return (ta > tb) - (ta < tb);
+}
+
+/* Out of time slots: renumber live blocks 0..n-1 in recency order and rebuild the tree */
+static void compact_time(sdist_t *sdist) {
+    sdist_block **order = (sdist_block **) malloc(sizeof(sdist_block *) * sdist->num_blocks);
+    uint32_t n = 0;
+
+    for (uint32_t i = 0; i < sdist->block_table_size; i++)
+        if (sdist->blocks[i].used)
+            order[n++] = &sdist->blocks[i];
+    qsort(order, n, sizeof(sdist_block *), compare_last_time);
+
+    while (n * 2 > sdist->fenwick_size)
+        sdist->fenwick_size *= 2;
+    free(sdist->fenwick);
+    sdist->fenwick = (uint32_t *) calloc(sdist->fenwick_size, sizeof(uint32_t));
+    sdist->time_owner = (uint32_t *) realloc(sdist->time_owner, sizeof(uint32_t) * sdist->fenwick_size);
+
+    for (uint32_t i = 0; i < n; i++) {
+        order[i]->last_time = i;
+        sdist->time_owner[i] = order[i]->block;
+        fenwick_add(sdist->fenwick, sdist->fenwick_size, i, 1);
+    }
+    sdist->now = n;
+
+    free(order);
+}
+
+bool sdist_init(sdist_t *sdist, int min_capacity, int max_capacity, int assoc, int block_size) {
+    memset(sdist, 0, sizeof(sdist_t));
+
+    if (min_capacity <= 0 || max_capacity < min_capacity || assoc < 0 || block_size <= 0)
+        return false;
+
+    sdist->assoc = assoc;
+    sdist->block_size = block_size;
+
+    for (int64_t c = min_capacity; c <= max_capacity && sdist->num_configs < SDIST_MAX_CONFIGS; c *= 2) {
+        int j = sdist->num_configs;
+
+        sdist->capacities[j] = (int) c;
+        if (assoc != SDIST_FULLY_ASSOC) {
+            sdist->num_sets[j] = ((int) c / assoc) / block_size;
+            if (sdist->num_sets[j] < 1)
+                return false;
+        } else if (c / block_size < 1) {
+            return false;
+        }
+        sdist->num_configs++;
+    }
+
+    if (assoc == SDIST_FULLY_ASSOC) {
+        sdist->histogram = (uint64_t *) calloc(SDIST_HISTOGRAM_BUCKETS, sizeof(uint64_t));
+        sdist->block_table_size = SDIST_INITIAL_BLOCKS;
+        sdist->blocks = (sdist_block *) calloc(sdist->block_table_size, sizeof(sdist_block));
+        sdist->fenwick_size = SDIST_INITIAL_TIME;
+        sdist->fenwick = (uint32_t *) calloc(sdist->fenwick_size, sizeof(uint32_t));
+        sdist->time_owner = (uint32_t *) malloc(sizeof(uint32_t) * sdist->fenwick_size);
+        return true;
+    }
+
+    if (assoc > UINT16_MAX)
+        return false;
+
+    for (int j = 0; j < sdist->num_configs; j++) {
+        sdist->stacks[j] = (sdist_entry *) calloc((size_t) sdist->num_sets[j] * assoc, sizeof(sdist_entry));
+        sdist->depths[j] = (uint16_t *) calloc(sdist->num_sets[j], sizeof(uint16_t));
+        sdist->set_histogram[j] = (uint64_t *) calloc(assoc + 1, sizeof(uint64_t));
+    }
+
+    return true;
+}
+
+static void count_access(cache_stats *stats, bool is_hit, bool is_trace_read) {
+    if (is_hit) {
+        if (is_trace_read)
+            stats->read_hits++;
+        else
+            stats->write_hits++;
+    } else {
+        if (is_trace_read)
+            stats->read_misses++;
+        else
+            stats->write_misses++;
+    }
+}
+
+/* Returns the stack distance of the access, SDIST_COLD for a block never seen before */
+static uint32_t fully_assoc_access(sdist_t *sdist, uint32_t block, bool is_trace_read) {
+    bool is_new;
+    uint32_t distance = SDIST_COLD;
+    sdist_block *entry = lookup_block(sdist, block, &is_new);
+    uint32_t live = fenwick_prefix(sdist->fenwick, sdist->now);
+
+    if (!is_new)
+        distance = live - fenwick_prefix(sdist->fenwick, entry->last_time + 1);
+
+    if (is_new)
+        sdist->histogram[SDIST_COLD_BUCKET]++;
+    else
+        sdist->histogram[distance ? 32 - __builtin_clz(distance) : 0]++;
+
+    for (int j = 0; j < sdist->num_configs; j++) {
+        uint32_t num_blocks = sdist->capacities[j] / sdist->block_size;
+        bool is_hit = distance < num_blocks;
+
+        count_access(&sdist->stats[j], is_hit, is_trace_read);
+
+        /* A miss pushes the block at depth num_blocks - 1 out of this capacity */
+        if (!is_hit && live >= num_blocks) {
+            uint32_t victim_time = fenwick_find(sdist->fenwick, sdist->fenwick_size, live - num_blocks + 1);
+            sdist_block *victim = find_block(sdist, sdist->time_owner[victim_time]);
+
+            if (victim->written && !(victim->evicted_mask & (1u << j)))
+                sdist->stats[j].write_backs++;
+            victim->evicted_mask |= 1u << j;
+        }
+    }
+
+    if (!is_trace_read) {
+        entry->written = true;
+        entry->evicted_mask = 0;
+    }
+
+    if (!is_new)
+        fenwick_add(sdist->fenwick, sdist->fenwick_size, entry->last_time, -1);
+    entry->last_time = sdist->now;
+    sdist->time_owner[sdist->now] = block;
+    fenwick_add(sdist->fenwick, sdist->fenwick_size, sdist->now, 1);
+    if (++sdist->now == sdist->fenwick_size)
+        compact_time(sdist);
+
+    return distance;
+}
+
+static void set_assoc_access(sdist_t *sdist, uint32_t block, bool is_trace_read) {
+    int assoc = sdist->assoc;
+
+    for (int j = 0; j < sdist->num_configs; j++) {
+        uint32_t set_index = block % sdist->num_sets[j];
+        sdist_entry *stack = sdist->stacks[j] + (size_t) set_index * assoc;
+        uint16_t *depth = &sdist->depths[j][set_index];
+        sdist_entry entry;
+        bool is_hit;
+        int d = 0;
+
+        while (d < *depth && stack[d].block != block)
+            d++;
+
+        is_hit = (d < *depth);
+        sdist->set_histogram[j][is_hit ? d : assoc]++;
+
+        if (is_hit) {
+            entry = stack[d];
+            entry.dirty |= !is_trace_read;
+            count_access(&sdist->stats[j], true, is_trace_read);
+        } else {
+            if (*depth == assoc) {
+                d = assoc - 1;
+                if (stack[d].dirty)
+                    sdist->stats[j].write_backs++;
+            } else {
+                d = (*depth)++;
+            }
+            entry.block = block;
+            entry.dirty = !is_trace_read;
+            count_access(&sdist->stats[j], false, is_trace_read);
+        }
+
+        memmove(stack + 1, stack, sizeof(sdist_entry) * d);
+        stack[0] = entry;
+    }
+}
+
+void sdist_access(sdist_t *sdist, uint32_t trace_address, bool is_trace_read) {
+    uint32_t block = trace_address / sdist->block_size;
+
+    if (sdist->assoc == SDIST_FULLY_ASSOC)
+        fully_assoc_access(sdist, block, is_trace_read);
+    else
+        set_assoc_access(sdist, block, is_trace_read);
+}
+
+/* Fully-associative access that also returns its stack distance, or SDIST_COLD */
+uint32_t sdist_distance(sdist_t *sdist, uint32_t trace_address, bool is_trace_read) {
+    return fully_assoc_access(sdist, trace_address / sdist->block_size, is_trace_read);
+}
+
+static void hdump(const sdist_t *sdist) {
+    if (sdist->assoc == SDIST_FULLY_ASSOC) {
+        printf("Stack Distance Histogram:\n");
+        printf("-------------------------------------\n");
+        for (int i = 0; i < SDIST_COLD_BUCKET; i++) {
+            if (sdist->histogram[i] == 0)
+                continue;
+            if (i == 0)
+                printf("[0, 1): %" PRIu64 "\n", sdist->histogram[i]);
+            else
+                printf("[%" PRIu64 ", %" PRIu64 "): %" PRIu64 "\n", (uint64_t) 1 << (i - 1), (uint64_t) 1 << i,
+                       sdist->histogram[i]);
+        }
+        printf("Cold: %" PRIu64 "\n", sdist->histogram[SDIST_COLD_BUCKET]);
+        printf("\n");
+        return;
+    }
+
+    for (int j = 0; j < sdist->num_configs; j++) {
+        printf("Stack Distance Histogram (%d sets):\n", sdist->num_sets[j]);
+        printf("-------------------------------------\n");
+        for (int d = 0; d < sdist->assoc; d++)
+            printf("%d: %" PRIu64 "\n", d, sdist->set_histogram[j][d]);
+        printf("Miss: %" PRIu64 "\n", sdist->set_histogram[j][sdist->assoc]);
+        printf("\n");
+    }
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : sdist_report                                    */
+/*                                                             */
+/* Purpose   : Dump every capacity in the same format as a     */
+/*             regular run, then optionally the histograms     */
+/*                                                             */
+/***************************************************************/
+void sdist_report(const sdist_t *sdist, bool print_csv, bool print_histogram) {
+    if (print_csv)
+        cache_report_csv_header();
+
+    for (int j = 0; j < sdist->num_configs; j++) {
+        int capacity = sdist->capacities[j];
+        int assoc = sdist->assoc == SDIST_FULLY_ASSOC ? capacity / sdist->block_size : sdist->assoc;
+
+        if (print_csv) {
+            stats_csv(capacity, assoc, sdist->block_size, "lru", &sdist->stats[j]);
+        } else {
+            cdump(capacity, assoc, sdist->block_size);
+            stats_dump(&sdist->stats[j]);
+        }
+    }
+
+    if (print_histogram)
+        hdump(sdist);
+}
+
+void sdist_free(sdist_t *sdist) {
+    free(sdist->histogram);
+    free(sdist->blocks);
+    free(sdist->fenwick);
+    free(sdist->time_owner);
+
+    for (int j = 0; j < sdist->num_configs; j++) {
+        free(sdist->stacks[j]);
+        free(sdist->depths[j]);
+        free(sdist->set_histogram[j]);
+    }
+
+    memset(sdist, 0, sizeof(sdist_t));
+}
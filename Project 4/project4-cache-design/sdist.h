@@ -0,0 +1,75 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   sdist.h                                                   */
+/*                                                             */
+/*   Stack-distance (Mattson) analysis: one pass over the      */
+/*   trace gives LRU hits, misses and write-backs for every    */
+/*   power-of-two capacity at a fixed associativity and block  */
+/*   size.                                                     */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _SDIST_H_
+#define _SDIST_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cache.h"
+
+#define SDIST_MAX_CONFIGS	32
+#define SDIST_FULLY_ASSOC	0
+#define SDIST_COLD		UINT32_MAX	/* distance of a first access */
+
+/* Fully-associative: last-use time of every block seen so far */
+typedef struct sdist_block {
+    uint32_t block;
+    uint32_t last_time;
+    uint32_t evicted_mask;	/* configs that evicted this block since its last write */
+    bool used;
+    bool written;
+} sdist_block;
+
+/* Set-associative: one LRU stack of depth assoc per set and per set count */
+typedef struct sdist_entry {
+    uint32_t block;
+    bool dirty;
+} sdist_entry;
+
+typedef struct sdist_s {
+    int assoc;		/* SDIST_FULLY_ASSOC or the fixed way count */
+    int block_size;
+    int num_configs;
+    int capacities[SDIST_MAX_CONFIGS];
+    cache_stats stats[SDIST_MAX_CONFIGS];
+
+    /* fully-associative engine */
+    uint64_t *histogram;	/* [0]: d == 0, [i]: 2^(i-1) <= d < 2^i, [33]: cold */
+    sdist_block *blocks;
+    uint32_t num_blocks;
+    uint32_t block_table_size;
+    uint32_t *fenwick;
+    uint32_t *time_owner;	/* block whose last use is at each time slot */
+    uint32_t fenwick_size;
+    uint32_t now;
+
+    /* set-associative engine */
+    int num_sets[SDIST_MAX_CONFIGS];
+    sdist_entry *stacks[SDIST_MAX_CONFIGS];
+    uint16_t *depths[SDIST_MAX_CONFIGS];
+    uint64_t *set_histogram[SDIST_MAX_CONFIGS];	/* [d] for d < assoc, [assoc]: miss */
+} sdist_t;
+
+#define SDIST_HISTOGRAM_BUCKETS	34
+
+/* Functions */
+bool	parse_sdist_args(char *sdist_args, int *min_capacity, int *max_capacity, int *assoc, int *block_size);
+bool	sdist_init(sdist_t *sdist, int min_capacity, int max_capacity, int assoc, int block_size);
+void	sdist_access(sdist_t *sdist, uint32_t trace_address, bool is_trace_read);
+uint32_t	sdist_distance(sdist_t *sdist, uint32_t trace_address, bool is_trace_read);
+void	sdist_report(const sdist_t *sdist, bool print_csv, bool print_histogram);
+void	sdist_free(sdist_t *sdist);
+
+#endif
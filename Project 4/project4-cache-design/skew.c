@@ -0,0 +1,206 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   skew.c                                                    */
+/*                                                             */
+/*   A hit probes one line per way. A miss first takes an      */
+/*   empty candidate, else walks breadth-first up to the       */
+/*   configured depth and evicts the least recently used       */
+/*   candidate, moving the blocks on its path down so the new  */
+/*   block lands in one of its own lines. Lines live in the    */
+/*   flat set layout of cache.c; only the set a way uses       */
+/*   differs.                                                  */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "cache.h"
+#include "skew.h"
+
+skew_t *skew_create(const cache_t *cache, int levels) {
+    skew_t *skew;
+
+    if (cache->assoc > MAX_ZCACHE_CANDIDATES || levels < 1 || levels > MAX_ZCACHE_LEVELS)
+        return NULL;
+
+    skew = (skew_t *) calloc(1, sizeof(skew_t));
+    skew->levels = levels;
+    skew->stamps = (uint64_t *) calloc((size_t) cache->num_sets * cache->assoc, sizeof(uint64_t));
+
+    return skew;
+}
+
+void skew_free(skew_t *skew) {
+    if (skew == NULL)
+        return;
+
+    free(skew->stamps);
+    free(skew);
+}
+
+static uint32_t way_set(const cache_t *cache, uint32_t block_address, uint32_t tag, int way) {
+    return (block_address ^ skew_hash(tag, way, cache->set_bits)) & (cache->num_sets - 1);
+}
+
+static bool is_candidate(const skew_t *skew, int num_candidates, uint32_t set, int way) {
+    for (int i = 0; i < num_candidates; i++) {
+        if (skew->candidates[i].set == set && skew->candidates[i].way == way)
+            return true;
+    }
+
+    return false;
+}
+
+/*
+ * Expand the walk level by level until a candidate is empty, the depth
+ * is reached or the candidate array is full. Returns the victim's index.
+ */
+static int find_victim(cache_t *cache, uint32_t block_address, uint32_t tag) {
+    skew_t *skew = cache->skew;
+    skew_candidate *candidates = skew->candidates;
+    int n = 0, level_start = 0, victim = -1;
+
+    for (int w = 0; w < cache->assoc; w++) {
+        candidates[n].set = way_set(cache, block_address, tag, w);
+        candidates[n].way = w;
+        candidates[n].parent = -1;
+        n++;
+    }
+
+    for (int level = 1; ; level++) {
+        int level_end = n;
+
+        for (int i = level_start; i < level_end; i++) {
+            uint64_t stamp = skew->stamps[(size_t) candidates[i].set * cache->assoc + candidates[i].way];
+
+            if (!TEST_WAY(SET_VALID(cache, candidates[i].set), candidates[i].way)) {
+                skew->walk_candidates += n;
+                return i;
+            }
+            if (victim < 0 || stamp < skew->stamps[(size_t) candidates[victim].set * cache->assoc +
+                                                   candidates[victim].way])
+                victim = i;
+        }
+        if (level == skew->levels)
+            break;
+
+        for (int i = level_start; i < level_end; i++) {
+            uint32_t block = block_addr(cache, candidates[i].set, candidates[i].way) / cache->block_size;
+            uint32_t block_tag = cache_tag(cache, block);
+
+            for (int w = 0; w < cache->assoc && n < MAX_ZCACHE_CANDIDATES; w++) {
+                uint32_t set = way_set(cache, block, block_tag, w);
+
+                if (w == candidates[i].way || is_candidate(skew, n, set, w))
+                    continue;
+                candidates[n].set = set;
+                candidates[n].way = w;
+                candidates[n].parent = i;
+                n++;
+            }
+        }
+        if (n == level_end)
+            break;
+        level_start = level_end;
+    }
+
+    skew->walk_candidates += n;
+    return victim;
+}
+
+/* Move the block in line from into line to, which is one of its other lines */
+static void relocate(cache_t *cache, const skew_candidate *from, const skew_candidate *to) {
+    skew_t *skew = cache->skew;
+    uint64_t *from_valid = SET_VALID(cache, from->set);
+    uint64_t *from_dirty = SET_DIRTY(cache, from->set);
+    uint64_t *to_valid = SET_VALID(cache, to->set);
+    uint64_t *to_dirty = SET_DIRTY(cache, to->set);
+
+    to_valid[to->way >> 6] |= WAY_BIT(to->way);
+    if (TEST_WAY(from_dirty, from->way))
+        to_dirty[to->way >> 6] |= WAY_BIT(to->way);
+    else
+        to_dirty[to->way >> 6] &= ~WAY_BIT(to->way);
+    SET_TAGS(cache, to->set)[to->way] = SET_TAGS(cache, from->set)[from->way];
+    skew->stamps[(size_t) to->set * cache->assoc + to->way] =
+        skew->stamps[(size_t) from->set * cache->assoc + from->way];
+
+    from_valid[from->way >> 6] &= ~WAY_BIT(from->way);
+    from_dirty[from->way >> 6] &= ~WAY_BIT(from->way);
+    skew->relocations++;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : skew_access                                     */
+/*                                                             */
+/* Purpose   : Simulate one read or write on a skewed cache or */
+/*             zcache with write-back, write-allocate.         */
+/*             Returns true on a hit.                          */
+/*                                                             */
+/***************************************************************/
+bool skew_access(cache_t *cache, uint32_t addr, bool is_read) {
+    skew_t *skew = cache->skew;
+    uint32_t block_address = addr / cache->block_size;
+    uint32_t tag = cache_tag(cache, block_address);
+    skew_candidate *line;
+    int victim;
+
+    skew->clock++;
+    for (int w = 0; w < cache->assoc; w++) {
+        uint32_t set = way_set(cache, block_address, tag, w);
+
+        if (SET_TAGS(cache, set)[w] == tag && TEST_WAY(SET_VALID(cache, set), w)) {
+            if (is_read)
+                cache->stats.read_hits++;
+            else {
+                cache->stats.write_hits++;
+                SET_DIRTY(cache, set)[w >> 6] |= WAY_BIT(w);
+            }
+            skew->stamps[(size_t) set * cache->assoc + w] = skew->clock;
+            return true;
+        }
+    }
+
+    if (is_read)
+        cache->stats.read_misses++;
+    else
+        cache->stats.write_misses++;
+
+    skew->walks++;
+    victim = find_victim(cache, block_address, tag);
+    line = &skew->candidates[victim];
+    if (cache->filter)
+        filter_emit(cache, block_address * cache->block_size, true);
+    if (TEST_WAY(SET_DIRTY(cache, line->set), line->way)) {
+        cache->stats.write_backs++;
+        if (cache->filter)
+            filter_emit(cache, block_addr(cache, line->set, line->way), false);
+    }
+
+    for (; line->parent >= 0; line = &skew->candidates[line->parent])
+        relocate(cache, &skew->candidates[line->parent], line);
+
+    SET_VALID(cache, line->set)[line->way >> 6] |= WAY_BIT(line->way);
+    if (is_read)
+        SET_DIRTY(cache, line->set)[line->way >> 6] &= ~WAY_BIT(line->way);
+    else
+        SET_DIRTY(cache, line->set)[line->way >> 6] |= WAY_BIT(line->way);
+    SET_TAGS(cache, line->set)[line->way] = tag;
+    skew->stamps[(size_t) line->set * cache->assoc + line->way] = skew->clock;
+
+    return false;
+}
+
+void skew_dump(const skew_t *skew) {
+    printf("Walk levels: %d\n", skew->levels);
+    printf("Candidates per miss: %.2f\n", skew->walks ? (double) skew->walk_candidates / skew->walks : 0.0);
+    printf("Relocations: %" PRIu64 "\n", skew->relocations);
+}
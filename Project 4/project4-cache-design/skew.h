@@ -0,0 +1,55 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   skew.h                                                    */
+/*                                                             */
+/*   Skewed-associative caches and zcaches. Both keep each way */
+/*   of a block in a different set, so replacement can't use   */
+/*   a set's policy metadata and picks the least recently used */
+/*   of the candidate lines by timestamp instead.              */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _SKEW_H_
+#define _SKEW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* A zcache walk stops growing at this many candidates */
+#define MAX_ZCACHE_CANDIDATES	64
+
+struct cache_s;
+
+/* One line a miss may replace, reached by relocating its parent's block into it */
+typedef struct skew_candidate {
+    uint32_t set;
+    int way;
+    int parent;		/* index of the candidate it was reached from, -1 at the first level */
+} skew_candidate;
+
+/*
+ * With one level the candidates are the block's own line in every way
+ * (a skewed cache). Each further level adds the other lines the blocks
+ * already found could move to; a victim found there is freed by moving
+ * every block on its path one step, as in a zcache.
+ */
+typedef struct skew_s {
+    int levels;
+    uint64_t *stamps;		/* last use of every line, num_sets * assoc */
+    uint64_t clock;
+    skew_candidate candidates[MAX_ZCACHE_CANDIDATES];
+
+    uint64_t walks;		/* misses that had to replace a line */
+    uint64_t walk_candidates;
+    uint64_t relocations;
+} skew_t;
+
+/* Functions */
+skew_t*	skew_create(const struct cache_s *cache, int levels);
+void	skew_free(skew_t *skew);
+bool	skew_access(struct cache_s *cache, uint32_t addr, bool is_read);
+void	skew_dump(const skew_t *skew);
+
+#endif
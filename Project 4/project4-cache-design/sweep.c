@@ -0,0 +1,473 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   sweep.c                                                   */
+/*                                                             */
+/*   Drives many cache configurations from a single pass over  */
+/*   the trace. The trace is read in chunks; each chunk is     */
+/*   replayed on every configuration before the next one is    */
+/*   consumed, so it is parsed only once.                      */
+/*                                                             */
+/*   Threads beyond one per configuration split a              */
+/*   configuration's sets into contiguous ranges. Sets never   */
+/*   interact, so each shard replays only the records mapping  */
+/*   to its range, on its own counters, and the counters are   */
+/*   merged at the end.                                        */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "sweep.h"
+#include "prefetch.h"
+#include "miss.h"
+#include "sample.h"
+#include "classify.h"
+#include "vm.h"
+
+typedef struct sweep_shared {
+    pthread_barrier_t chunk_ready;
+    pthread_barrier_t chunk_done;
+    const trace_record *records;
+    size_t num_records;
+    bool done;
+} sweep_shared;
+
+/* One configuration, or one set range of it with private counters */
+typedef struct sweep_task {
+    cache_t *cache;
+    cache_t *owner;		/* configuration a shard's counters are merged into */
+    cache_t shard;		/* copy sharing owner->sets, used when sharded */
+    uint32_t first_set;
+    uint32_t last_set;		/* exclusive */
+    bool sharded;
+} sweep_task;
+
+typedef struct sweep_worker {
+    pthread_t thread;
+    sweep_shared *shared;
+    sweep_task *tasks;
+    int num_tasks;
+    int first;
+    int stride;
+} sweep_worker;
+
+void add_config(config_list *list, int capacity, int assoc, int block_size) {
+    if (list->num_configs == list->max_configs) {
+        list->max_configs = list->max_configs ? list->max_configs * 2 : 16;
+        list->configs = (cache_config *) realloc(list->configs, sizeof(cache_config) * list->max_configs);
+    }
+
+    list->configs[list->num_configs].capacity = capacity;
+    list->configs[list->num_configs].assoc = assoc;
+    list->configs[list->num_configs].block_size = block_size;
+    list->configs[list->num_configs].policy = REPL_LRU;
+    list->configs[list->num_configs].seed = 1;
+    list->configs[list->num_configs].index = INDEX_MOD;
+    list->configs[list->num_configs].zcache_levels = DEFAULT_ZCACHE_LEVELS;
+    list->num_configs++;
+}
+
+/* A field is a comma separated list of values or lo-hi ranges stepping by powers of two */
+static int parse_sweep_field(char *field, int *values, int max_values) {
+    int count = 0;
+    char *save, *item;
+
+    for (item = strtok_r(field, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        char *dash = strchr(item, '-');
+        int lo = strtol(item, NULL, 10);
+        int hi = dash ? strtol(dash + 1, NULL, 10) : lo;
+
+        if (lo <= 0 || hi < lo)
+            return -1;
+        for (int v = lo; v <= hi && count < max_values; v *= 2)
+            values[count++] = v;
+    }
+
+    return count;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_sweep_args                                */
+/*                                                             */
+/* Purpose   : Expand a capacity:assoc:blocksize grid such as  */
+/*             1024-65536:1,2,4,8:8-64 into configurations     */
+/*                                                             */
+/***************************************************************/
+bool parse_sweep_args(char *sweep_args, config_list *list) {
+    int values[3][32];
+    int counts[3];
+    int field_num = 0;
+    char *save, *field;
+
+    for (field = strtok_r(sweep_args, ":", &save); field; field = strtok_r(NULL, ":", &save)) {
+        if (field_num == 3)
+            return false;
+        counts[field_num] = parse_sweep_field(field, values[field_num], 32);
+        if (counts[field_num] <= 0)
+            return false;
+        field_num++;
+    }
+
+    if (field_num != 3)
+        return false;
+
+    for (int c = 0; c < counts[0]; c++)
+        for (int a = 0; a < counts[1]; a++)
+            for (int b = 0; b < counts[2]; b++)
+                add_config(list, values[0][c], values[1][a], values[2][b]);
+
+    return true;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_policy_args                               */
+/*                                                             */
+/* Purpose   : Replicate every configuration once per policy   */
+/*             in a list such as lru,plru,random:42 where the  */
+/*             optional number seeds the policy's generator.   */
+/*                                                             */
+/***************************************************************/
+bool parse_policy_args(char *policy_args, config_list *list) {
+    config_list expanded;
+    char *save, *item;
+
+    memset(&expanded, 0, sizeof(config_list));
+
+    for (item = strtok_r(policy_args, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        char *colon = strchr(item, ':');
+        uint64_t seed = 1;
+        int policy;
+
+        if (colon) {
+            *colon = '\0';
+            seed = strtoull(colon + 1, NULL, 10);
+        }
+
+        policy = find_repl_policy(item);
+        if (policy < 0) {
+            free(expanded.configs);
+            return false;
+        }
+
+        for (int i = 0; i < list->num_configs; i++) {
+            cache_config *config = &list->configs[i];
+
+            add_config(&expanded, config->capacity, config->assoc, config->block_size);
+            expanded.configs[expanded.num_configs - 1].policy = policy;
+            expanded.configs[expanded.num_configs - 1].seed = seed;
+        }
+    }
+
+    free(list->configs);
+    *list = expanded;
+    return true;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_index_args                                */
+/*                                                             */
+/* Purpose   : Replicate every configuration once per set      */
+/*             indexing in a list such as mod,xor,skew,z:3     */
+/*                                                             */
+/***************************************************************/
+bool parse_index_args(char *index_args, config_list *list) {
+    config_list expanded;
+    char *save, *item;
+
+    memset(&expanded, 0, sizeof(config_list));
+
+    for (item = strtok_r(index_args, ",", &save); item; item = strtok_r(NULL, ",", &save)) {
+        int levels;
+        int index = parse_index(item, &levels);
+
+        if (index < 0) {
+            free(expanded.configs);
+            return false;
+        }
+
+        for (int i = 0; i < list->num_configs; i++) {
+            cache_config *config = &list->configs[i];
+
+            add_config(&expanded, config->capacity, config->assoc, config->block_size);
+            expanded.configs[expanded.num_configs - 1].policy = config->policy;
+            expanded.configs[expanded.num_configs - 1].seed = config->seed;
+            expanded.configs[expanded.num_configs - 1].index = index;
+            expanded.configs[expanded.num_configs - 1].zcache_levels = levels;
+        }
+    }
+
+    free(list->configs);
+    *list = expanded;
+    return true;
+}
+
+size_t fill_chunk(trace_reader *reader, trace_record *chunk, size_t max_records) {
+    size_t n = 0;
+
+    while (n < max_records && trace_next(reader, &chunk[n]))
+        n++;
+
+    return n;
+}
+
+static void count_walk(cache_stats *stats, bool is_hit) {
+    if (is_hit)
+        stats->walk_hits++;
+    else
+        stats->walk_misses++;
+}
+
+static void replay_chunk(cache_t *cache, const trace_record *records, size_t num_records) {
+    bool with_miss = (cache->victim || cache->mshr);
+
+    if (cache->sample) {
+        for (size_t i = 0; i < num_records; i++)
+            sample_access(cache, &records[i]);
+        return;
+    }
+
+    if (cache->prefetch == NULL && !with_miss && cache->classify == NULL && !cache->walk_stats) {
+        cache->replay(cache, records, num_records);
+        return;
+    }
+
+    for (size_t i = 0; i < num_records; i++) {
+        bool is_hit = with_miss ? miss_access(cache, &records[i])
+                                : cache_access(cache, records[i].addr, records[i].is_read);
+
+        if (records[i].is_walk)
+            count_walk(&cache->stats, is_hit);
+        if (cache->classify)
+            classify_access(cache->classify, records[i].addr, records[i].is_read, is_hit);
+        if (cache->prefetch)
+            prefetch_access(cache, &records[i], is_hit);
+    }
+}
+
+static void replay_shard(cache_t *cache, const trace_record *records, size_t num_records,
+                         uint32_t first_set, uint32_t last_set) {
+    for (size_t i = 0; i < num_records; i++) {
+        uint32_t set_index = cache_set(cache, records[i].addr / cache->block_size);
+
+        if (set_index - first_set < last_set - first_set) {
+            bool is_hit = cache_access(cache, records[i].addr, records[i].is_read);
+
+            if (records[i].is_walk)
+                count_walk(&cache->stats, is_hit);
+        }
+    }
+}
+
+static void replay_task(sweep_task *task, const trace_record *records, size_t num_records) {
+    if (task->sharded)
+        replay_shard(task->cache, records, num_records, task->first_set, task->last_set);
+    else
+        replay_chunk(task->cache, records, num_records);
+}
+
+/*
+ * Split configurations into set ranges while there are more threads than
+ * configurations. Policies that draw from the cache's generator (random,
+ * BRRIP) would see a different sequence per shard, which would change
+ * their victims and insertions. Prefetchers fill into other sets, and
+ * victim caches, MSHRs and write buffers are shared by all sets. Sampled
+ * configurations count records in trace order, and a profile's region table
+ * and the miss classifier's shadow cache are shared by all sets. A skewed
+ * cache spreads each block over several sets, and a miss stream is written
+ * in trace order. Such configurations always stay whole.
+ */
+static sweep_task *make_tasks(cache_t *caches, int num_caches, int num_threads, int *num_tasks) {
+    int shards = (num_threads > num_caches) ? num_threads / num_caches : 1;
+    sweep_task *tasks = (sweep_task *) calloc((size_t) num_caches * shards, sizeof(sweep_task));
+    int n = 0;
+
+    for (int i = 0; i < num_caches; i++) {
+        cache_t *cache = &caches[i];
+        bool whole = (cache->policy->uses_rng || cache->prefetch || cache->victim ||
+                      cache->mshr || cache->wbuf || cache->sample || cache->profile ||
+                      cache->classify || cache->skew || cache->filter);
+        int k = whole ? 1 : shards;
+
+        if (k > cache->num_sets)
+            k = cache->num_sets;
+
+        if (k == 1) {
+            tasks[n].cache = cache;
+            n++;
+            continue;
+        }
+
+        for (int j = 0; j < k; j++) {
+            sweep_task *task = &tasks[n++];
+
+            task->shard = *cache;
+            memset(&task->shard.stats, 0, sizeof(cache_stats));
+            task->cache = &task->shard;
+            task->owner = cache;
+            task->first_set = (uint64_t) cache->num_sets * j / k;
+            task->last_set = (uint64_t) cache->num_sets * (j + 1) / k;
+            task->sharded = true;
+        }
+    }
+
+    *num_tasks = n;
+    return tasks;
+}
+
+static void merge_tasks(sweep_task *tasks, int num_tasks) {
+    for (int t = 0; t < num_tasks; t++) {
+        cache_stats *dst;
+        const cache_stats *src = &tasks[t].shard.stats;
+
+        if (!tasks[t].sharded)
+            continue;
+
+        dst = &tasks[t].owner->stats;
+        dst->read_hits += src->read_hits;
+        dst->read_misses += src->read_misses;
+        dst->write_hits += src->write_hits;
+        dst->write_misses += src->write_misses;
+        dst->write_backs += src->write_backs;
+        dst->write_throughs += src->write_throughs;
+        dst->walk_hits += src->walk_hits;
+        dst->walk_misses += src->walk_misses;
+    }
+}
+
+static void *sweep_worker_main(void *arg) {
+    sweep_worker *worker = (sweep_worker *) arg;
+    sweep_shared *shared = worker->shared;
+
+    for (;;) {
+        pthread_barrier_wait(&shared->chunk_ready);
+        if (shared->done)
+            break;
+
+        for (int i = worker->first; i < worker->num_tasks; i += worker->stride)
+            replay_task(&worker->tasks[i], shared->records, shared->num_records);
+
+        pthread_barrier_wait(&shared->chunk_done);
+    }
+
+    return NULL;
+}
+
+/* A translated access may expand into a whole walk, so stop while one still fits */
+static size_t fill_translated(trace_reader *reader, vm_t *vm, trace_record *chunk, uint64_t *left) {
+    trace_record record;
+    size_t n = 0;
+
+    while (*left > 0 && n + VM_MAX_RECORDS <= SWEEP_CHUNK_RECORDS && trace_next(reader, &record)) {
+        n += vm_translate(vm, &record, chunk + n);
+        (*left)--;
+    }
+
+    return n;
+}
+
+/* Next chunk, never reading past the records left in this run */
+static size_t next_chunk(trace_reader *reader, vm_t *vm, trace_record *chunk, uint64_t *left) {
+    size_t n;
+
+    if (vm)
+        return fill_translated(reader, vm, chunk, left);
+
+    n = fill_chunk(reader, chunk, (*left < SWEEP_CHUNK_RECORDS) ? (size_t) *left : SWEEP_CHUNK_RECORDS);
+    *left -= n;
+    return n;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : sweep_run                                       */
+/*                                                             */
+/* Purpose   : Replay the whole trace on every configuration.  */
+/*             With several threads, configurations (or set    */
+/*             ranges of them) are dealt round-robin to        */
+/*             workers while the calling thread reads the next */
+/*             chunk into the other buffer. Stops after        */
+/*             max_records unless it is 0, and returns the     */
+/*             number of trace records replayed. With a vm,    */
+/*             addresses are translated first and the walks'   */
+/*             PTE reads replayed along with them.             */
+/*                                                             */
+/***************************************************************/
+uint64_t sweep_run(trace_reader *reader, vm_t *vm, cache_t *caches, int num_caches, int num_threads,
+                   uint64_t max_records) {
+    trace_record *buffers[2];
+    sweep_shared shared;
+    sweep_worker *workers;
+    sweep_task *tasks;
+    int num_tasks;
+    uint64_t limit = max_records ? max_records : UINT64_MAX;
+    uint64_t left = limit;
+    size_t n;
+    int cur = 0;
+
+    buffers[0] = (trace_record *) malloc(sizeof(trace_record) * SWEEP_CHUNK_RECORDS);
+    buffers[1] = (trace_record *) malloc(sizeof(trace_record) * SWEEP_CHUNK_RECORDS);
+
+    if (num_threads <= 1) {
+        while ((n = next_chunk(reader, vm, buffers[0], &left)) > 0)
+            for (int i = 0; i < num_caches; i++)
+                replay_chunk(&caches[i], buffers[0], n);
+
+        free(buffers[0]);
+        free(buffers[1]);
+        return limit - left;
+    }
+
+    tasks = make_tasks(caches, num_caches, num_threads, &num_tasks);
+    if (num_threads > num_tasks)
+        num_threads = num_tasks;
+
+    memset(&shared, 0, sizeof(sweep_shared));
+    pthread_barrier_init(&shared.chunk_ready, NULL, num_threads + 1);
+    pthread_barrier_init(&shared.chunk_done, NULL, num_threads + 1);
+
+    workers = (sweep_worker *) calloc(num_threads, sizeof(sweep_worker));
+    for (int t = 0; t < num_threads; t++) {
+        workers[t].shared = &shared;
+        workers[t].tasks = tasks;
+        workers[t].num_tasks = num_tasks;
+        workers[t].first = t;
+        workers[t].stride = num_threads;
+        pthread_create(&workers[t].thread, NULL, sweep_worker_main, &workers[t]);
+    }
+
+    n = next_chunk(reader, vm, buffers[cur], &left);
+    for (;;) {
+        shared.records = buffers[cur];
+        shared.num_records = n;
+        shared.done = (n == 0);
+        pthread_barrier_wait(&shared.chunk_ready);
+        if (n == 0)
+            break;
+
+        n = next_chunk(reader, vm, buffers[cur ^ 1], &left);
+        pthread_barrier_wait(&shared.chunk_done);
+        cur ^= 1;
+    }
+
+    for (int t = 0; t < num_threads; t++)
+        pthread_join(workers[t].thread, NULL);
+    merge_tasks(tasks, num_tasks);
+
+    pthread_barrier_destroy(&shared.chunk_ready);
+    pthread_barrier_destroy(&shared.chunk_done);
+    free(workers);
+    free(tasks);
+    free(buffers[0]);
+    free(buffers[1]);
+    return limit - left;
+}
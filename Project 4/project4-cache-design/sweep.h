@@ -0,0 +1,35 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   sweep.h                                                   */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _SWEEP_H_
+#define _SWEEP_H_
+
+#include "cache.h"
+#include "trace.h"
+
+struct vm_s;
+
+/* Records handed to the configurations per pass over a chunk */
+#define SWEEP_CHUNK_RECORDS	65536
+
+typedef struct config_list {
+    cache_config *configs;
+    int num_configs;
+    int max_configs;
+} config_list;
+
+/* Functions */
+void	add_config(config_list *list, int capacity, int assoc, int block_size);
+bool	parse_sweep_args(char *sweep_args, config_list *list);
+bool	parse_policy_args(char *policy_args, config_list *list);
+bool	parse_index_args(char *index_args, config_list *list);
+size_t	fill_chunk(trace_reader *reader, trace_record *chunk, size_t max_records);
+uint64_t	sweep_run(trace_reader *reader, struct vm_s *vm, cache_t *caches, int num_caches, int num_threads,
+		  uint64_t max_records);
+
+#endif
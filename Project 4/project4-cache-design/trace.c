@@ -0,0 +1,614 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   trace.c                                                   */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <zlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trace.h"
+#include "live.h"
+
+/* Longest binary record: a 5-byte varint or raw record plus a core ID and a PC */
+#define TRACE_MAX_RECORD_SIZE	(TRACE_RAW_RECORD_SIZE + 2 + 4)
+
+/*
+ * Reader thread state. The thread decodes into slot (head + count) of a
+ * ring of record blocks; the simulator consumes slot head and releases it
+ * when it asks for the next one.
+ */
+struct trace_stream {
+    gzFile gz;			/* also reads uncompressed input transparently */
+    FILE *pipe;			/* zstd -dc, for .zst traces */
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    trace_record *blocks[TRACE_QUEUE_BLOCKS];
+    size_t lengths[TRACE_QUEUE_BLOCKS];
+    int head;
+    int count;
+    bool holding;		/* the simulator is reading blocks[head] */
+    bool eof;
+    bool stop;
+
+    /* owned by the reader thread once it runs */
+    uint8_t *buf;
+    size_t buf_length;
+    size_t buf_pos;
+    bool buf_eof;
+    bool is_binary;
+    uint32_t flags;
+    int op_bits;
+    uint32_t prev_addr;
+};
+
+static uint32_t load_u32(const uint8_t *p) {
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint64_t load_u64(const uint8_t *p) {
+    return (uint64_t) load_u32(p) | ((uint64_t) load_u32(p + 4) << 32);
+}
+
+static void store_u32(uint8_t *p, uint32_t value) {
+    p[0] = (uint8_t) value;
+    p[1] = (uint8_t) (value >> 8);
+    p[2] = (uint8_t) (value >> 16);
+    p[3] = (uint8_t) (value >> 24);
+}
+
+static void store_u64(uint8_t *p, uint64_t value) {
+    store_u32(p, (uint32_t) value);
+    store_u32(p + 4, (uint32_t) (value >> 32));
+}
+
+void parse_trace_args(char *trace_entry, bool *is_read_trace, uint32_t *trace_address, uint16_t *core,
+                      uint32_t *pc) {
+    int trace_arg_num = 0;
+    char *save, *token;
+    *core = 0;
+    *pc = 0;
+    token = strtok_r(trace_entry, " ", &save);
+
+    while (token) {
+        switch (trace_arg_num) {
+            case 0:
+                *is_read_trace = (token[0] == 'R' || token[0] == 'I');
+                break;
+            case 1:
+                *trace_address = strtol(token, NULL, 16);
+                break;
+            default:
+                if (token[0] == '0' && (token[1] == 'x' || token[1] == 'X'))
+                    *pc = strtoul(token, NULL, 16);
+                else
+                    *core = strtol(token, NULL, 10);
+                break;
+        }
+
+        token = strtok_r(NULL, " ", &save);
+        trace_arg_num++;
+    }
+}
+
+/* Decode one binary record at *cursor. Returns false at the end of the data. */
+static bool decode_record(const uint8_t **cursor, const uint8_t *end, uint32_t flags, int op_bits,
+                          uint32_t *prev_addr, trace_record *record) {
+    const uint8_t *p = *cursor;
+
+    if (flags & TRACE_FLAG_DELTA) {
+        uint64_t value = 0;
+        int shift = 0;
+
+        do {
+            if (p == end || shift > 35)
+                return false;
+            value |= (uint64_t) (*p & 0x7f) << shift;
+            shift += 7;
+        } while (*p++ & 0x80);
+
+        uint32_t op = value & ((1 << op_bits) - 1);
+        uint32_t zigzag = (uint32_t) (value >> op_bits);
+        *prev_addr += (zigzag >> 1) ^ -(zigzag & 1);
+        record->addr = *prev_addr;
+        record->is_read = (op != TRACE_OP_WRITE);
+        record->is_fetch = (op == TRACE_OP_FETCH);
+        record->is_walk = false;
+    } else {
+        if (end - p < TRACE_RAW_RECORD_SIZE)
+            return false;
+        record->is_read = (p[0] != TRACE_OP_WRITE);
+        record->is_fetch = (p[0] == TRACE_OP_FETCH);
+        record->is_walk = false;
+        record->addr = load_u32(p + 1);
+        p += TRACE_RAW_RECORD_SIZE;
+    }
+
+    record->core = 0;
+    if (flags & TRACE_FLAG_CORE) {
+        if (end - p < 2)
+            return false;
+        record->core = (uint16_t) (p[0] | (p[1] << 8));
+        p += 2;
+    }
+
+    record->pc = 0;
+    if (flags & TRACE_FLAG_PC) {
+        if (end - p < 4)
+            return false;
+        record->pc = load_u32(p);
+        p += 4;
+    }
+
+    *cursor = p;
+    return true;
+}
+
+/* Check a header and take flags and op width from it */
+static bool parse_header(const uint8_t *base, uint32_t *flags, int *op_bits) {
+    uint32_t version = load_u32(base + 8);
+
+    if (memcmp(base, TRACE_MAGIC, TRACE_MAGIC_SIZE) != 0 || version < TRACE_MIN_VERSION || version > TRACE_VERSION)
+        return false;
+
+    *flags = load_u32(base + 12);
+    *op_bits = (version == 1) ? 1 : 2;
+    return true;
+}
+
+/* Make at least need bytes available past buf_pos, unless the input ends first */
+static size_t stream_fill(struct trace_stream *stream, size_t need) {
+    size_t avail = stream->buf_length - stream->buf_pos;
+
+    if (avail >= need || stream->buf_eof)
+        return avail;
+
+    memmove(stream->buf, stream->buf + stream->buf_pos, avail);
+    stream->buf_length = avail;
+    stream->buf_pos = 0;
+
+    while (stream->buf_length < need && !stream->buf_eof) {
+        int n = gzread(stream->gz, stream->buf + stream->buf_length, TRACE_STREAM_BUFFER - stream->buf_length);
+
+        if (n <= 0)
+            stream->buf_eof = true;
+        else
+            stream->buf_length += n;
+    }
+
+    return stream->buf_length;
+}
+
+/* Decode up to max_records records from the input. Returns 0 at the end. */
+static size_t decode_block(struct trace_stream *stream, trace_record *records, size_t max_records) {
+    size_t n = 0;
+
+    while (n < max_records) {
+        if (stream->is_binary) {
+            const uint8_t *p, *end;
+
+            stream_fill(stream, TRACE_MAX_RECORD_SIZE);
+            p = stream->buf + stream->buf_pos;
+            end = stream->buf + stream->buf_length;
+            if (!decode_record(&p, end, stream->flags, stream->op_bits, &stream->prev_addr, &records[n]))
+                break;
+            stream->buf_pos = p - stream->buf;
+            n++;
+            continue;
+        }
+
+        /* Text: one line per record; a line longer than the buffer is cut */
+        size_t avail = stream->buf_length - stream->buf_pos;
+        char *line = (char *) stream->buf + stream->buf_pos;
+        char *newline = memchr(line, '\n', avail);
+
+        if (newline == NULL && !stream->buf_eof && avail < TRACE_STREAM_BUFFER) {
+            stream_fill(stream, avail + 1);
+            continue;
+        }
+        if (avail == 0)
+            break;
+
+        if (newline) {
+            *newline = '\0';
+            stream->buf_pos += newline - line + 1;
+        } else {
+            line[avail] = '\0';
+            stream->buf_pos = stream->buf_length;
+        }
+
+        if (line[0] != 'R' && line[0] != 'W' && line[0] != 'I')
+            continue;
+        records[n].is_fetch = (line[0] == 'I');
+        records[n].is_walk = false;
+        parse_trace_args(line, &records[n].is_read, &records[n].addr, &records[n].core, &records[n].pc);
+        n++;
+    }
+
+    return n;
+}
+
+static void *stream_main(void *arg) {
+    struct trace_stream *stream = (struct trace_stream *) arg;
+
+    for (;;) {
+        bool stop;
+        int tail;
+        size_t n;
+
+        pthread_mutex_lock(&stream->lock);
+        while (stream->count == TRACE_QUEUE_BLOCKS && !stream->stop)
+            pthread_cond_wait(&stream->not_full, &stream->lock);
+        tail = (stream->head + stream->count) % TRACE_QUEUE_BLOCKS;
+        stop = stream->stop;
+        pthread_mutex_unlock(&stream->lock);
+        if (stop)
+            break;
+
+        n = decode_block(stream, stream->blocks[tail], TRACE_BLOCK_RECORDS);
+
+        pthread_mutex_lock(&stream->lock);
+        if (n > 0) {
+            stream->lengths[tail] = n;
+            stream->count++;
+        } else {
+            stream->eof = true;
+        }
+        pthread_cond_signal(&stream->not_empty);
+        pthread_mutex_unlock(&stream->lock);
+
+        if (n == 0)
+            break;
+    }
+
+    return NULL;
+}
+
+/* Start a reader thread on fd, or on zstd's output for .zst files. Takes ownership of fd. */
+static bool stream_open(trace_reader *reader, int fd, const char *path) {
+    struct trace_stream *stream = (struct trace_stream *) calloc(1, sizeof(struct trace_stream));
+    size_t path_length = strlen(path);
+
+    if (path_length > 4 && strcmp(path + path_length - 4, ".zst") == 0) {
+        char *command = (char *) malloc(path_length * 4 + 32);
+        char *q = command + sprintf(command, "zstd -dc -- '");
+
+        /* Quote the path for the shell */
+        for (const char *c = path; *c; c++) {
+            if (*c == '\'')
+                q += sprintf(q, "'\\''");
+            else
+                *q++ = *c;
+        }
+        strcpy(q, "'");
+
+        close(fd);
+        stream->pipe = popen(command, "r");
+        free(command);
+        if (stream->pipe == NULL) {
+            free(stream);
+            return false;
+        }
+        fd = dup(fileno(stream->pipe));
+    }
+
+    stream->gz = gzdopen(fd, "rb");
+    if (stream->gz == NULL) {
+        close(fd);
+        if (stream->pipe)
+            pclose(stream->pipe);
+        free(stream);
+        return false;
+    }
+    gzbuffer(stream->gz, 1 << 17);
+
+    stream->buf = (uint8_t *) malloc(TRACE_STREAM_BUFFER + 1);
+    for (int i = 0; i < TRACE_QUEUE_BLOCKS; i++)
+        stream->blocks[i] = (trace_record *) malloc(sizeof(trace_record) * TRACE_BLOCK_RECORDS);
+
+    /* The format is known before the thread starts, so callers can inspect the flags */
+    if (stream_fill(stream, TRACE_HEADER_SIZE) >= TRACE_HEADER_SIZE &&
+        parse_header(stream->buf, &stream->flags, &stream->op_bits)) {
+        stream->is_binary = true;
+        stream->buf_pos = TRACE_HEADER_SIZE;
+        reader->flags = stream->flags;
+        reader->op_bits = stream->op_bits;
+        reader->num_records = load_u64(stream->buf + 16);
+    }
+
+    pthread_mutex_init(&stream->lock, NULL);
+    pthread_cond_init(&stream->not_empty, NULL);
+    pthread_cond_init(&stream->not_full, NULL);
+    reader->stream = stream;
+    pthread_create(&stream->thread, NULL, stream_main, stream);
+    return true;
+}
+
+/* Release the block being read and wait for the next one */
+static bool stream_next_block(trace_reader *reader) {
+    struct trace_stream *stream = reader->stream;
+    bool ok;
+
+    pthread_mutex_lock(&stream->lock);
+    if (stream->holding) {
+        stream->head = (stream->head + 1) % TRACE_QUEUE_BLOCKS;
+        stream->count--;
+        stream->holding = false;
+        pthread_cond_signal(&stream->not_full);
+    }
+
+    while (stream->count == 0 && !stream->eof)
+        pthread_cond_wait(&stream->not_empty, &stream->lock);
+
+    ok = (stream->count > 0);
+    if (ok) {
+        stream->holding = true;
+        reader->block = stream->blocks[stream->head];
+        reader->block_length = stream->lengths[stream->head];
+        reader->block_pos = 0;
+    }
+    pthread_mutex_unlock(&stream->lock);
+
+    return ok;
+}
+
+static void stream_close(struct trace_stream *stream) {
+    pthread_mutex_lock(&stream->lock);
+    stream->stop = true;
+    pthread_cond_signal(&stream->not_full);
+    pthread_mutex_unlock(&stream->lock);
+    pthread_join(stream->thread, NULL);
+
+    gzclose(stream->gz);
+    if (stream->pipe)
+        pclose(stream->pipe);
+
+    pthread_mutex_destroy(&stream->lock);
+    pthread_cond_destroy(&stream->not_empty);
+    pthread_cond_destroy(&stream->not_full);
+    for (int i = 0; i < TRACE_QUEUE_BLOCKS; i++)
+        free(stream->blocks[i]);
+    free(stream->buf);
+    free(stream);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : trace_open                                      */
+/*                                                             */
+/* Purpose   : Open a trace. Uncompressed binary files are     */
+/*             recognised by their magic and memory-mapped.    */
+/*             Anything else (text, .gz, .zst, a FIFO, "-" for */
+/*             stdin, or a unix:path socket that is waited on  */
+/*             for a writer) is decoded by a reader thread. A  */
+/*             shm:/name ring is read in place.                */
+/*                                                             */
+/***************************************************************/
+bool trace_open(trace_reader *reader, const char *path) {
+    struct stat st;
+    int fd;
+
+    memset(reader, 0, sizeof(trace_reader));
+
+    if (is_live_path(path, LIVE_SHM_PREFIX)) {
+        reader->ring = live_ring_create(path + strlen(LIVE_SHM_PREFIX));
+        return reader->ring != NULL;
+    }
+    if (is_live_path(path, LIVE_UNIX_PREFIX)) {
+        fd = live_accept(path + strlen(LIVE_UNIX_PREFIX));
+        return fd >= 0 && stream_open(reader, fd, path);
+    }
+
+    fd = (strcmp(path, "-") == 0) ? dup(STDIN_FILENO) : open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= TRACE_HEADER_SIZE) {
+        void *map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map != MAP_FAILED) {
+            const uint8_t *base = (const uint8_t *) map;
+
+            if (parse_header(base, &reader->flags, &reader->op_bits)) {
+                madvise(map, st.st_size, MADV_SEQUENTIAL);
+                close(fd);
+
+                reader->is_mapped = true;
+                reader->map = base;
+                reader->map_size = st.st_size;
+                reader->num_records = load_u64(base + 16);
+                reader->cursor = base + TRACE_HEADER_SIZE;
+                reader->end = base + st.st_size;
+                return true;
+            }
+            munmap(map, st.st_size);
+        }
+    }
+
+    return stream_open(reader, fd, path);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : trace_next                                      */
+/*                                                             */
+/* Purpose   : Fetch the next access. Mapped records are       */
+/*             decoded in place, streamed ones come from the   */
+/*             reader thread and ring records straight from    */
+/*             shared memory, a block at a time.               */
+/*                                                             */
+/***************************************************************/
+bool trace_next(trace_reader *reader, trace_record *record) {
+    if (reader->is_mapped)
+        return decode_record(&reader->cursor, reader->end, reader->flags, reader->op_bits, &reader->prev_addr,
+                             record);
+
+    if (reader->ring) {
+        if (reader->block_pos == reader->block_length) {
+            reader->block_length = live_ring_next(reader->ring, &reader->block, reader->block_length);
+            reader->block_pos = 0;
+            if (reader->block_length == 0)
+                return false;
+        }
+        *record = reader->block[reader->block_pos++];
+        return true;
+    }
+
+    if (reader->block_pos == reader->block_length && !stream_next_block(reader))
+        return false;
+
+    *record = reader->block[reader->block_pos++];
+    return true;
+}
+
+/* Skip up to n accesses; raw mapped traces jump straight there. Returns the number skipped. */
+uint64_t trace_skip(trace_reader *reader, uint64_t n) {
+    trace_record record;
+    uint64_t skipped = 0;
+
+    if (reader->is_mapped && !(reader->flags & TRACE_FLAG_DELTA)) {
+        size_t record_size = TRACE_RAW_RECORD_SIZE + ((reader->flags & TRACE_FLAG_CORE) ? 2 : 0) +
+                             ((reader->flags & TRACE_FLAG_PC) ? 4 : 0);
+        uint64_t left = (reader->end - reader->cursor) / record_size;
+
+        skipped = (n < left) ? n : left;
+        reader->cursor += skipped * record_size;
+        return skipped;
+    }
+
+    while (skipped < n && trace_next(reader, &record))
+        skipped++;
+
+    return skipped;
+}
+
+void trace_close(trace_reader *reader) {
+    if (reader->is_mapped)
+        munmap((void *) reader->map, reader->map_size);
+    else if (reader->stream)
+        stream_close(reader->stream);
+    else if (reader->ring)
+        live_ring_close(reader->ring);
+
+    memset(reader, 0, sizeof(trace_reader));
+}
+
+static uint8_t trace_op(const trace_record *record) {
+    if (record->is_fetch)
+        return TRACE_OP_FETCH;
+
+    return record->is_read ? TRACE_OP_READ : TRACE_OP_WRITE;
+}
+
+static void write_header(trace_writer *writer) {
+    uint8_t header[TRACE_HEADER_SIZE];
+
+    memcpy(header, TRACE_MAGIC, TRACE_MAGIC_SIZE);
+    store_u32(header + 8, TRACE_VERSION);
+    store_u32(header + 12, writer->flags);
+    store_u64(header + 16, writer->num_records);
+    fwrite(header, 1, TRACE_HEADER_SIZE, writer->fp);
+}
+
+/* Paths are as for trace_open(); unix: and shm: writers wait for the reader to create their end */
+bool trace_writer_open(trace_writer *writer, const char *path, uint32_t flags) {
+    memset(writer, 0, sizeof(trace_writer));
+
+    if (is_live_path(path, LIVE_SHM_PREFIX)) {
+        writer->ring = live_ring_attach(path + strlen(LIVE_SHM_PREFIX));
+        writer->flags = flags;
+        return writer->ring != NULL;
+    }
+
+    if (is_live_path(path, LIVE_UNIX_PREFIX)) {
+        int fd = live_connect(path + strlen(LIVE_UNIX_PREFIX));
+
+        if (fd >= 0 && (writer->fp = fdopen(fd, "wb")) == NULL)
+            close(fd);
+    } else {
+        writer->fp = fopen(path, "wb");
+    }
+    if (writer->fp == NULL)
+        return false;
+
+    writer->flags = flags;
+    write_header(writer);
+    return true;
+}
+
+void trace_write(trace_writer *writer, const trace_record *record) {
+    uint8_t buf[TRACE_MAX_RECORD_SIZE];
+    size_t len = 0;
+
+    if (writer->ring) {
+        live_ring_write(writer->ring, record);
+        writer->num_records++;
+        return;
+    }
+
+    if (writer->flags & TRACE_FLAG_DELTA) {
+        int32_t delta = (int32_t) (record->addr - writer->prev_addr);
+        uint32_t zigzag = ((uint32_t) delta << 1) ^ (uint32_t) (delta >> 31);
+        uint64_t value = ((uint64_t) zigzag << 2) | trace_op(record);
+
+        do {
+            buf[len] = value & 0x7f;
+            value >>= 7;
+            if (value)
+                buf[len] |= 0x80;
+            len++;
+        } while (value);
+
+        writer->prev_addr = record->addr;
+    } else {
+        buf[0] = trace_op(record);
+        store_u32(buf + 1, record->addr);
+        len = TRACE_RAW_RECORD_SIZE;
+    }
+
+    if (writer->flags & TRACE_FLAG_CORE) {
+        buf[len++] = (uint8_t) record->core;
+        buf[len++] = (uint8_t) (record->core >> 8);
+    }
+
+    if (writer->flags & TRACE_FLAG_PC) {
+        store_u32(buf + len, record->pc);
+        len += 4;
+    }
+
+    fwrite(buf, 1, len, writer->fp);
+    writer->num_records++;
+}
+
+/*
+ * The record count is only known at the end, so the header is rewritten on
+ * close. FIFOs and sockets can't seek back and keep a count of 0.
+ */
+void trace_writer_close(trace_writer *writer) {
+    if (writer->ring) {
+        live_ring_close(writer->ring);
+        writer->ring = NULL;
+        return;
+    }
+    if (writer->fp == NULL)
+        return;
+
+    if (fseek(writer->fp, 0, SEEK_SET) == 0)
+        write_header(writer);
+    fclose(writer->fp);
+    writer->fp = NULL;
+}
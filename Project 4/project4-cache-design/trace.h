@@ -0,0 +1,110 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   trace.h                                                   */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * Binary trace layout (all integers little-endian)
+ *
+ *   header : magic[8] "CS311TRC", u32 version, u32 flags, u64 num_records
+ *   body   : num_records packed records
+ *
+ *   raw record   (flags & TRACE_FLAG_DELTA == 0) : u8 op, u32 address
+ *   delta record (flags & TRACE_FLAG_DELTA != 0) : LEB128 varint of
+ *                (zigzag(address - previous address) << 2) | op
+ *
+ *   op is 0 for a read, 1 for a write and 2 for an instruction fetch
+ *   ("I 0x..." in text traces). Version 1 files have no fetches and
+ *   shift the delta by one bit only.
+ *
+ *   With TRACE_FLAG_CORE every record is followed by a u16 core ID,
+ *   then with TRACE_FLAG_PC by the u32 PC of the access. In text
+ *   traces both are optional columns after the address: a decimal
+ *   core ID and a 0x-prefixed PC ("R 0x... 3 0x4005d0").
+ */
+#define TRACE_MAGIC		"CS311TRC"
+#define TRACE_MAGIC_SIZE	8
+#define TRACE_VERSION		2
+#define TRACE_MIN_VERSION	1
+#define TRACE_HEADER_SIZE	24
+#define TRACE_RAW_RECORD_SIZE	5
+
+#define TRACE_FLAG_DELTA	0x1
+#define TRACE_FLAG_CORE		0x2
+#define TRACE_FLAG_PC		0x4
+
+#define TRACE_OP_READ		0
+#define TRACE_OP_WRITE		1
+#define TRACE_OP_FETCH		2
+
+/* Text, compressed and piped traces are decoded on a reader thread */
+#define TRACE_BLOCK_RECORDS	4096	/* records per block handed to the simulator */
+#define TRACE_QUEUE_BLOCKS	8	/* decoded blocks the reader thread may run ahead */
+#define TRACE_STREAM_BUFFER	(1 << 20)
+
+typedef struct trace_record {
+    uint32_t addr;
+    bool is_read;		/* true for reads and instruction fetches */
+    bool is_fetch;
+    bool is_walk;		/* PTE read inserted by the page walker of -V */
+    uint16_t core;		/* issuing core, 0 when the trace is not tagged */
+    uint32_t pc;		/* instruction address, 0 when the trace is not tagged */
+} trace_record;
+
+struct trace_stream;
+struct live_ring;
+
+typedef struct trace_reader {
+    bool is_mapped;
+
+    /* streamed traces and shared-memory rings: the block currently being consumed */
+    struct trace_stream *stream;
+    struct live_ring *ring;
+    const trace_record *block;
+    size_t block_length;
+    size_t block_pos;
+
+    /* binary traces, mapped read-only */
+    const uint8_t *map;
+    size_t map_size;
+    const uint8_t *cursor;
+    const uint8_t *end;
+
+    /* binary header, also filled in for streamed binary traces */
+    uint32_t flags;
+    int op_bits;
+    uint32_t prev_addr;
+    uint64_t num_records;
+} trace_reader;
+
+typedef struct trace_writer {
+    FILE *fp;
+    struct live_ring *ring;	/* shm: writers store records directly */
+    uint32_t flags;
+    uint32_t prev_addr;
+    uint64_t num_records;
+} trace_writer;
+
+/* Functions */
+void	parse_trace_args(char *trace_entry, bool *is_read_trace, uint32_t *trace_address, uint16_t *core,
+			 uint32_t *pc);
+bool	trace_open(trace_reader *reader, const char *path);
+bool	trace_next(trace_reader *reader, trace_record *record);
+uint64_t	trace_skip(trace_reader *reader, uint64_t n);
+void	trace_close(trace_reader *reader);
+bool	trace_writer_open(trace_writer *writer, const char *path, uint32_t flags);
+void	trace_write(trace_writer *writer, const trace_record *record);
+void	trace_writer_close(trace_writer *writer);
+
+#endif
@@ -0,0 +1,346 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   vm.c                                                      */
+/*                                                             */
+/*   An access first looks up its page in the L1 TLB (ITLB     */
+/*   for fetches when present, else DTLB), then in the STLB.   */
+/*   A miss in both walks the page table from the root,        */
+/*   emitting one PTE read per level ahead of the access, and  */
+/*   fills the STLB and the L1 TLB. TLBs are cache_t's driven  */
+/*   through cache_lookup() and cache_insert().                */
+/*                                                             */
+/*   The page table itself is kept in a hash table keyed by    */
+/*   level and address prefix, which doubles when half full.   */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "vm.h"
+
+static const char *tlb_names[NUM_TLBS] = { "itlb", "dtlb", "stlb" };
+static const char *tlb_titles[NUM_TLBS] = { "ITLB", "DTLB", "STLB" };
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_vm_args                                   */
+/*                                                             */
+/* Purpose   : Parse the page size with an optional K, M or G  */
+/*             suffix, e.g. 4K or 2M                           */
+/*                                                             */
+/***************************************************************/
+bool parse_vm_args(char *vm_args, vm_t *vm) {
+    char *end;
+    uint64_t size = strtoull(vm_args, &end, 10);
+
+    if (*end == 'K' || *end == 'k')
+        size <<= 10;
+    else if (*end == 'M' || *end == 'm')
+        size <<= 20;
+    else if (*end == 'G' || *end == 'g')
+        size <<= 30;
+
+    if (size < ((uint64_t) 1 << VM_MIN_PAGE_BITS) || size > ((uint64_t) 1 << VM_MAX_PAGE_BITS) ||
+        (size & (size - 1)))
+        return false;
+
+    vm->page_size = (uint32_t) size;
+    return true;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : parse_tlb_args                                  */
+/*                                                             */
+/* Purpose   : Parse name=entries:assoc[:policy], e.g.         */
+/*             stlb=1536:12                                    */
+/*                                                             */
+/***************************************************************/
+bool parse_tlb_args(char *tlb_args, vm_t *vm) {
+    char *equals = strchr(tlb_args, '=');
+    tlb_level *tlb = NULL;
+    int tlb_arg_num = 0;
+    char *token;
+
+    if (equals == NULL)
+        return false;
+    *equals = '\0';
+
+    for (int i = 0; i < NUM_TLBS; i++) {
+        if (strcmp(tlb_args, tlb_names[i]) == 0)
+            tlb = &vm->tlbs[i];
+    }
+    if (tlb == NULL)
+        return false;
+
+    tlb->present = true;
+    tlb->config.block_size = 1;
+    tlb->config.policy = REPL_LRU;
+    tlb->config.seed = 1;
+
+    token = strtok(equals + 1, ":");
+    while (token) {
+        switch (tlb_arg_num) {
+            case 0:
+                tlb->config.capacity = strtol(token, NULL, 10);
+                break;
+            case 1:
+                tlb->config.assoc = strtol(token, NULL, 10);
+                break;
+            case 2:
+                tlb->config.policy = find_repl_policy(token);
+                if (tlb->config.policy < 0)
+                    return false;
+                break;
+        }
+
+        token = strtok(NULL, ":");
+        tlb_arg_num++;
+    }
+
+    return tlb_arg_num >= 2 && tlb_arg_num <= 3;
+}
+
+/* Without -t, a DTLB and STLB sized like a current x86 core's 4KB-page TLBs */
+static void default_tlbs(vm_t *vm) {
+    static const int entries[NUM_TLBS] = { 0, 64, 1536 };
+    static const int assocs[NUM_TLBS] = { 0, 4, 12 };
+
+    for (int i = TLB_DTLB; i < NUM_TLBS; i++) {
+        vm->tlbs[i].present = true;
+        vm->tlbs[i].config.capacity = entries[i];
+        vm->tlbs[i].config.assoc = assocs[i];
+        vm->tlbs[i].config.block_size = 1;
+        vm->tlbs[i].config.policy = REPL_LRU;
+        vm->tlbs[i].config.seed = 1;
+    }
+}
+
+static uint32_t hash_key(uint64_t key) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ull;
+
+    return (uint32_t) (h >> 32);
+}
+
+static vm_mapping *find_slot(vm_mapping *slots, uint32_t num_slots, uint64_t key) {
+    uint32_t i = hash_key(key) & (num_slots - 1);
+
+    while (slots[i].key != 0 && slots[i].key != key)
+        i = (i + 1) & (num_slots - 1);
+
+    return &slots[i];
+}
+
+static void grow_mappings(vm_t *vm) {
+    uint32_t old_slots = vm->mapping_slots;
+    vm_mapping *old = vm->mappings;
+
+    vm->mapping_slots = old_slots * 2;
+    vm->mappings = (vm_mapping *) calloc(vm->mapping_slots, sizeof(vm_mapping));
+    for (uint32_t i = 0; i < old_slots; i++) {
+        if (old[i].key != 0)
+            *find_slot(vm->mappings, vm->mapping_slots, old[i].key) = old[i];
+    }
+    free(old);
+}
+
+/* Node tables and frames share one physical space and must not meet */
+static uint32_t allocate(vm_t *vm, bool is_frame) {
+    uint64_t base;
+
+    if (vm->next_frame + (is_frame ? vm->page_size : VM_NODE_SIZE) > vm->next_node) {
+        printf("Error: the trace's pages and page tables don't fit in 4GB of physical memory\n");
+        exit(1);
+    }
+
+    if (is_frame) {
+        base = vm->next_frame;
+        vm->next_frame += vm->page_size;
+        vm->pages++;
+    } else {
+        vm->next_node -= VM_NODE_SIZE;
+        base = vm->next_node;
+        vm->nodes++;
+    }
+
+    return (uint32_t) base;
+}
+
+/*
+ * Level 1 .. num_levels - 1 are page table nodes below the root and level
+ * num_levels is the data frame; each is named by the address bits above
+ * the ones its parent's PTE index consumes.
+ */
+static uint32_t lookup_mapping(vm_t *vm, int level, uint32_t addr) {
+    uint64_t key = ((uint64_t) level << 32) | (addr >> vm->level_shift[level - 1]);
+    vm_mapping *slot = find_slot(vm->mappings, vm->mapping_slots, key);
+
+    if (slot->key == 0) {
+        if (2 * (vm->num_mappings + 1) > vm->mapping_slots) {
+            grow_mappings(vm);
+            slot = find_slot(vm->mappings, vm->mapping_slots, key);
+        }
+        slot->key = key;
+        slot->base = allocate(vm, level == vm->num_levels);
+        vm->num_mappings++;
+    }
+
+    return slot->base;
+}
+
+bool vm_init(vm_t *vm) {
+    bool any_tlb = false;
+    int bits;
+
+    if (vm->page_size == 0)
+        vm->page_size = DEFAULT_PAGE_SIZE;
+    for (vm->page_bits = 0; ((uint32_t) 1 << vm->page_bits) < vm->page_size; vm->page_bits++)
+        ;
+
+    bits = 32 - vm->page_bits;
+    vm->num_levels = (bits + VM_LEVEL_BITS - 1) / VM_LEVEL_BITS;
+    for (int i = vm->num_levels - 1, shift = vm->page_bits; i >= 0; i--, shift += VM_LEVEL_BITS) {
+        vm->level_shift[i] = shift;
+        vm->level_bits[i] = (i == 0) ? 32 - shift : VM_LEVEL_BITS;
+    }
+
+    for (int i = 0; i < NUM_TLBS; i++)
+        any_tlb |= vm->tlbs[i].present;
+    if (!any_tlb)
+        default_tlbs(vm);
+    if (!vm->tlbs[TLB_DTLB].present)
+        return false;
+    for (int i = 0; i < NUM_TLBS; i++) {
+        if (vm->tlbs[i].present && !cache_init(&vm->tlbs[i].cache, &vm->tlbs[i].config))
+            return false;
+    }
+
+    vm->mapping_slots = 1024;
+    vm->mappings = (vm_mapping *) calloc(vm->mapping_slots, sizeof(vm_mapping));
+    vm->next_frame = 0;
+    vm->next_node = (uint64_t) 1 << 32;
+    vm->root = allocate(vm, false);
+
+    return true;
+}
+
+static bool tlb_lookup(tlb_level *tlb, uint32_t vpn) {
+    if (cache_lookup(&tlb->cache, vpn, false)) {
+        tlb->hits++;
+        return true;
+    }
+
+    tlb->misses++;
+    return false;
+}
+
+static void tlb_fill(tlb_level *tlb, uint32_t vpn) {
+    uint32_t victim_addr;
+    bool victim_dirty;
+
+    cache_insert(&tlb->cache, vpn, false, &victim_addr, &victim_dirty);
+}
+
+/* Emit the PTE read of every level, allocating the nodes the walk passes through */
+static int walk(vm_t *vm, const trace_record *record, trace_record *out) {
+    uint32_t node = vm->root;
+
+    for (int i = 0; i < vm->num_levels; i++) {
+        uint32_t index = (record->addr >> vm->level_shift[i]) & ((1u << vm->level_bits[i]) - 1);
+
+        out[i] = *record;
+        out[i].addr = node + index * VM_PTE_SIZE;
+        out[i].is_read = true;
+        out[i].is_fetch = false;
+        out[i].is_walk = true;
+        if (i + 1 < vm->num_levels)
+            node = lookup_mapping(vm, i + 1, record->addr);
+    }
+
+    vm->walks++;
+    vm->pte_reads += vm->num_levels;
+    return vm->num_levels;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : vm_translate                                    */
+/*                                                             */
+/* Purpose   : Translate one virtual access into out,          */
+/*             preceded by the PTE reads of a page walk if     */
+/*             every TLB misses. Returns the number of records */
+/*             written, at most VM_MAX_RECORDS.                */
+/*                                                             */
+/***************************************************************/
+int vm_translate(vm_t *vm, const trace_record *record, trace_record *out) {
+    uint32_t vpn = record->addr >> vm->page_bits;
+    tlb_level *l1 = &vm->tlbs[(record->is_fetch && vm->tlbs[TLB_ITLB].present) ? TLB_ITLB : TLB_DTLB];
+    tlb_level *stlb = &vm->tlbs[TLB_STLB];
+    int n = 0;
+
+    vm->translations++;
+    if (!tlb_lookup(l1, vpn)) {
+        if (!stlb->present || !tlb_lookup(stlb, vpn)) {
+            n = walk(vm, record, out);
+            if (stlb->present)
+                tlb_fill(stlb, vpn);
+        }
+        tlb_fill(l1, vpn);
+    }
+
+    out[n] = *record;
+    out[n].addr = lookup_mapping(vm, vm->num_levels, record->addr) | (record->addr & (vm->page_size - 1));
+    return n + 1;
+}
+
+static void tlb_dump(const tlb_level *tlb, int index) {
+    uint64_t accesses = tlb->hits + tlb->misses;
+
+    printf("%s: %d entries, %dway, %s\n", tlb_titles[index], tlb->cache.capacity, tlb->cache.assoc,
+           tlb->cache.policy->name);
+    printf("%s hits: %" PRIu64 "\n", tlb_titles[index], tlb->hits);
+    printf("%s misses: %" PRIu64 "\n", tlb_titles[index], tlb->misses);
+    printf("%s miss rate: %.2f%%\n", tlb_titles[index], accesses ? 100.0 * tlb->misses / accesses : 0.0);
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : vm_report                                       */
+/*                                                             */
+/* Purpose   : Dump TLB and page walk stat. What the walks     */
+/*             cost in cache misses is in each configuration's */
+/*             Page Walk Stat.                                 */
+/*                                                             */
+/***************************************************************/
+void vm_report(const vm_t *vm) {
+    printf("Translation Stat:\n");
+    printf("-------------------------------------\n");
+    printf("Page size: %" PRIu32 "B\n", vm->page_size);
+    printf("Page table levels: %d\n", vm->num_levels);
+    printf("Pages touched: %" PRIu64 "\n", vm->pages);
+    printf("Page table nodes: %" PRIu64 "\n", vm->nodes);
+    printf("Translations: %" PRIu64 "\n", vm->translations);
+    for (int i = 0; i < NUM_TLBS; i++) {
+        if (vm->tlbs[i].present)
+            tlb_dump(&vm->tlbs[i], i);
+    }
+    printf("Page walks: %" PRIu64 "\n", vm->walks);
+    printf("PTE reads: %" PRIu64 "\n", vm->pte_reads);
+    printf("Walks per 1K accesses: %.2f\n", vm->translations ? 1000.0 * vm->walks / vm->translations : 0.0);
+    printf("\n");
+}
+
+void vm_free(vm_t *vm) {
+    for (int i = 0; i < NUM_TLBS; i++) {
+        if (vm->tlbs[i].present)
+            cache_free(&vm->tlbs[i].cache);
+    }
+    free(vm->mappings);
+}
@@ -0,0 +1,94 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   vm.h                                                      */
+/*                                                             */
+/*   Virtual-memory front end: trace addresses are virtual,    */
+/*   translated through TLBs and a radix page table whose PTE  */
+/*   reads are replayed on the caches like any other access.   */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _VM_H_
+#define _VM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "cache.h"
+#include "trace.h"
+
+#define TLB_ITLB	0
+#define TLB_DTLB	1
+#define TLB_STLB	2
+#define NUM_TLBS	3
+
+/*
+ * Page table nodes are 4KB and hold 512 8-byte PTEs, so every level
+ * resolves 9 bits and the root takes whatever is left of the 32-bit
+ * address: 3 levels for 4KB pages, 2 for 2MB and 1 for 1GB.
+ */
+#define VM_PTE_SIZE		8
+#define VM_NODE_SIZE		4096
+#define VM_LEVEL_BITS		9
+#define VM_MIN_PAGE_BITS	12
+#define VM_MAX_PAGE_BITS	30
+#define VM_MAX_LEVELS		3
+#define VM_MAX_RECORDS		(VM_MAX_LEVELS + 1)	/* PTE reads plus the access itself */
+
+#define DEFAULT_PAGE_SIZE	4096
+
+/* One TLB, a cache_t of virtual page numbers with one-byte "blocks" */
+typedef struct tlb_level {
+    bool present;
+    cache_config config;
+    cache_t cache;
+    uint64_t hits;
+    uint64_t misses;
+} tlb_level;
+
+/* A page table node or data frame in the open-addressing page table */
+typedef struct vm_mapping {
+    uint64_t key;		/* level << 32 | address prefix, 0 when unused */
+    uint32_t base;		/* physical address */
+} vm_mapping;
+
+/*
+ * Data frames are handed out from physical address 0 up and page table
+ * nodes from the top of memory down, both the first time the trace
+ * touches them, so the caches see physical addresses and the PTEs never
+ * share blocks with data. Every walk reads one PTE per level; there are
+ * no paging-structure caches, and page faults cost nothing.
+ */
+typedef struct vm_s {
+    uint32_t page_size;
+    int page_bits;
+    int num_levels;
+    int level_shift[VM_MAX_LEVELS];	/* lowest address bit indexing each level */
+    int level_bits[VM_MAX_LEVELS];
+    tlb_level tlbs[NUM_TLBS];
+
+    vm_mapping *mappings;
+    uint32_t num_mappings;
+    uint32_t mapping_slots;	/* power of two */
+    uint32_t root;
+    uint64_t next_frame;
+    uint64_t next_node;
+
+    uint64_t translations;
+    uint64_t walks;
+    uint64_t pte_reads;
+    uint64_t pages;
+    uint64_t nodes;
+} vm_t;
+
+/* Functions */
+bool	parse_vm_args(char *vm_args, vm_t *vm);
+bool	parse_tlb_args(char *tlb_args, vm_t *vm);
+bool	vm_init(vm_t *vm);
+int	vm_translate(vm_t *vm, const trace_record *record, trace_record *out);
+void	vm_report(const vm_t *vm);
+void	vm_free(vm_t *vm);
+
+#endif
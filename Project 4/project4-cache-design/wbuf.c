@@ -0,0 +1,88 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   wbuf.c                                                    */
+/*                                                             */
+/*   A drained entry costs one transfer of the words written   */
+/*   into it. Blocks of more than 64 words are tracked as      */
+/*   whole blocks.                                             */
+/*                                                             */
+/***************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "wbuf.h"
+
+write_buffer *wbuf_create(int depth, int block_size) {
+    write_buffer *wbuf = (write_buffer *) calloc(1, sizeof(write_buffer));
+
+    wbuf->depth = depth;
+    wbuf->block_size = block_size;
+    wbuf->entries = (wbuf_entry *) calloc(depth, sizeof(wbuf_entry));
+    return wbuf;
+}
+
+void wbuf_free(write_buffer *wbuf) {
+    if (wbuf == NULL)
+        return;
+
+    free(wbuf->entries);
+    free(wbuf);
+}
+
+static uint64_t entry_bytes(const write_buffer *wbuf, const wbuf_entry *entry) {
+    if (wbuf->block_size > 64 * CACHE_WORD_SIZE)
+        return wbuf->block_size;
+
+    return (uint64_t) __builtin_popcountll(entry->words) * CACHE_WORD_SIZE;
+}
+
+/***************************************************************/
+/*                                                             */
+/* Procedure : wbuf_write                                      */
+/*                                                             */
+/* Purpose   : Buffer one store, combining it with a pending   */
+/*             store to the same block                         */
+/*                                                             */
+/***************************************************************/
+void wbuf_write(write_buffer *wbuf, uint32_t addr) {
+    uint32_t block = addr / wbuf->block_size;
+    uint64_t word = (uint64_t) 1 << ((addr % wbuf->block_size) / CACHE_WORD_SIZE % 64);
+    wbuf_entry *entry;
+
+    for (int i = 0; i < wbuf->count; i++) {
+        entry = &wbuf->entries[(wbuf->head + i) % wbuf->depth];
+        if (entry->block == block) {
+            entry->words |= word;
+            wbuf->combined++;
+            return;
+        }
+    }
+
+    if (wbuf->count == wbuf->depth) {
+        wbuf->drained_bytes += entry_bytes(wbuf, &wbuf->entries[wbuf->head]);
+        wbuf->drains++;
+        wbuf->head = (wbuf->head + 1) % wbuf->depth;
+        wbuf->count--;
+    }
+
+    entry = &wbuf->entries[(wbuf->head + wbuf->count) % wbuf->depth];
+    entry->block = block;
+    entry->words = word;
+    wbuf->count++;
+}
+
+/* Bytes sent so far plus what the entries still pending will send */
+uint64_t wbuf_bytes(const write_buffer *wbuf) {
+    uint64_t bytes = wbuf->drained_bytes;
+
+    for (int i = 0; i < wbuf->count; i++)
+        bytes += entry_bytes(wbuf, &wbuf->entries[(wbuf->head + i) % wbuf->depth]);
+
+    return bytes;
+}
@@ -0,0 +1,44 @@
+/***************************************************************/
+/*                                                             */
+/*   CS311 Cache Simulator                                     */
+/*                                                             */
+/*   wbuf.h                                                    */
+/*                                                             */
+/*   Write-combining buffer for stores sent past the cache.    */
+/*                                                             */
+/***************************************************************/
+
+#ifndef _WBUF_H_
+#define _WBUF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define CACHE_WORD_SIZE		4	/* bytes written by one store */
+
+/* One block being combined: which of its words have been written */
+typedef struct wbuf_entry {
+    uint32_t block;
+    uint64_t words;
+} wbuf_entry;
+
+/* FIFO of depth entries; the oldest drains when a new block needs room */
+typedef struct write_buffer {
+    int depth;
+    int block_size;
+    wbuf_entry *entries;
+    int head;
+    int count;
+
+    uint64_t combined;		/* stores merged into a pending entry */
+    uint64_t drains;
+    uint64_t drained_bytes;
+} write_buffer;
+
+/* Functions */
+write_buffer*	wbuf_create(int depth, int block_size);
+void		wbuf_free(write_buffer *wbuf);
+void		wbuf_write(write_buffer *wbuf, uint32_t addr);
+uint64_t	wbuf_bytes(const write_buffer *wbuf);
+
+#endif